@@ -0,0 +1,202 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <sys/resource.h>
+
+#include "gameboy.hh"
+
+/**
+ * @brief
+ * Headless benchmark runner. Runs a rom for a fixed number of frames with no
+ * frame cap and no SDL linked in, then reports the raw emulation speed.
+ * --flag-sweep runs every opcode from random states instead and prints a
+ * hash per opcode, no rom needed, for comparing against a LAZY_FLAGS build.
+ *
+ * usage: ./gameboy-bench romFilename [-f frames] [--trace traceFile] [--block-cache] [--jit] [--no-halt-skip] [--no-idle-skip] [--save] [--save-interval ms] [--memory-profile file] [--colours scheme] [--lcd-format format] [--ppu-bench] [--flag-sweep]
+ */
+
+#define DEFAULT_BENCH_FRAMES 600
+
+// frames worth of scanlines each pixel kernel draws in --ppu-bench
+#define PPU_BENCH_FRAMES 2000
+
+// random register states each opcode is run from in --flag-sweep
+#define FLAG_SWEEP_SAMPLES 20000
+
+// the real hardware runs at CLOCK_SPEED / MAX_CYCLE frames a second
+#define DMG_FRAME_RATE ((double) CLOCK_SPEED / MAX_CYCLE)
+
+static long peakRSSKilobytes(){
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    // macOS reports bytes, linux reports kilobytes
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static void printUsage(){
+    std::cout << "usage: ./gameboy-bench romFilename [-f frames] [--trace traceFile] [--block-cache] [--jit] [--no-halt-skip] [--no-idle-skip] [--save] [--save-interval ms] [--memory-profile file] [--colours scheme] [--lcd-format format] [--ppu-bench] [--flag-sweep]" << std::endl;
+}
+
+int main(int argc, char **argv){
+    std::string filename = "";
+    std::string traceFilename = "";
+    std::string memoryProfileFilename = "";
+    std::string colourScheme = "";
+    std::string lcdFormat = "";
+    int frames = DEFAULT_BENCH_FRAMES;
+    bool useBlockCache = false;
+    bool useJIT = false;
+    bool haltFastForward = true;
+    bool idleLoopSkip = true;
+    // off by default so every run starts from the same ram
+    bool batterySave = false;
+    // time the scanline renderer with every pixel kernel once the frames have run
+    bool ppuBench = false;
+    bool flagSweep = false;
+    int saveInterval = SAVE_SYNC_INTERVAL_MS;
+
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if((arg == "-f" || arg == "--frames") && i + 1 < argc){
+            frames = std::stoi(argv[++i]);
+        }
+        else if(arg == "--trace" && i + 1 < argc){
+            traceFilename = argv[++i];
+        }
+        else if(arg == "--memory-profile" && i + 1 < argc){
+            memoryProfileFilename = argv[++i];
+        }
+        else if(arg == "--colours" && i + 1 < argc){
+            colourScheme = argv[++i];
+        }
+        else if(arg == "--lcd-format" && i + 1 < argc){
+            lcdFormat = argv[++i];
+        }
+        else if(arg == "--block-cache"){
+            useBlockCache = true;
+        }
+        else if(arg == "--jit"){
+            useJIT = true;
+        }
+        else if(arg == "--no-halt-skip"){
+            haltFastForward = false;
+        }
+        else if(arg == "--no-idle-skip"){
+            idleLoopSkip = false;
+        }
+        else if(arg == "--ppu-bench"){
+            ppuBench = true;
+        }
+        else if(arg == "--flag-sweep"){
+            flagSweep = true;
+        }
+        else if(arg == "--save"){
+            batterySave = true;
+        }
+        else if(arg == "--save-interval" && i + 1 < argc){
+            batterySave = true;
+            saveInterval = std::stoi(argv[++i]);
+        }
+        else if(filename.empty()){
+            filename = arg;
+        }
+        else{
+            printUsage();
+            return 1;
+        }
+    }
+
+    if((filename.empty() && !flagSweep) || frames <= 0){
+        printUsage();
+        return 1;
+    }
+
+    Gameboy *gameboy = new Gameboy(filename);
+    if(flagSweep){
+        for(int opcode = 0; opcode < SWEEP_OPCODES; opcode++){
+            printf("flags %s%02x %016llx\n", opcode >= 0x100 ? "cb " : "", opcode & 0xFF, (unsigned long long) gameboy->sweepOpcode(opcode, FLAG_SWEEP_SAMPLES));
+        }
+        return 0;
+    }
+    gameboy->toggleBlockCache(useBlockCache);
+    gameboy->toggleHaltFastForward(haltFastForward);
+    gameboy->toggleIdleLoopSkip(idleLoopSkip);
+    if(batterySave && !gameboy->enableBatterySave(saveInterval)){
+        batterySave = false;
+    }
+    if(!colourScheme.empty() && !gameboy->setColourScheme(colourScheme)){
+        printUsage();
+        return 1;
+    }
+    if(!lcdFormat.empty() && !gameboy->setLCDFormat(lcdFormat)){
+        printUsage();
+        return 1;
+    }
+    if(useJIT && !gameboy->toggleJIT(true)){
+        useJIT = false;
+    }
+
+    std::string core = useJIT ? "jit" : (useBlockCache ? "block cache" : "interpreter");
+    if(!traceFilename.empty()){
+        gameboy->toggleDebugMode(true);
+    }
+    if(!memoryProfileFilename.empty()){
+        gameboy->profileMemory(memoryProfileFilename);
+    }
+
+    // every update emulates MAX_CYCLE cycles, which is one frame of emulated time
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+    for(int i = 0; i < frames; i++){
+        gameboy->update();
+    }
+    std::chrono::time_point<std::chrono::steady_clock> end = std::chrono::steady_clock::now();
+
+    // outside the timing, the emulation itself never waits on the disk
+    if(batterySave){
+        gameboy->flushBatterySave();
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(end - start).count();
+    double elapsedNanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+    uint64_t instructions = gameboy->getInstructionCount();
+
+    double framesPerSecond = frames / elapsedSeconds;
+
+    printf("\n");
+    printf("cpu core:           %s\n", core.c_str());
+    printf("mbc:                %s\n", gameboy->getMBCName());
+    printf("frames emulated:    %d (%d drawn by the ppu)\n", frames, gameboy->frame);
+    printf("host time:          %.3f s\n", elapsedSeconds);
+    printf("frames/s:           %.1f (%.1fx real time)\n", framesPerSecond, framesPerSecond / DMG_FRAME_RATE);
+    printf("instructions/s:     %.0f\n", instructions / elapsedSeconds);
+    printf("ns/frame:           %.0f\n", elapsedNanoseconds / frames);
+    printf("peak rss:           %ld KB\n", peakRSSKilobytes());
+    printf("last frame:         %016llx (%s, %zu bytes)\n", (unsigned long long) gameboy->frameHash(), gameboy->getLCDFormatName(), gameboy->getFrameSize());
+    printf("halted cycles:      %llu skipped\n", (unsigned long long) gameboy->haltCyclesSkipped);
+    printf("idle loop cycles:   %llu skipped (%.0f per frame)\n", (unsigned long long) gameboy->idleCyclesSkipped, (double) gameboy->idleCyclesSkipped / frames);
+    if(useJIT){
+        printf("native runs:        %llu\n", (unsigned long long) gameboy->getJITRunsCompiled());
+    }
+
+    if(ppuBench){
+        printf("\nscanline rendering, the last frame's vram drawn %d times:\n", PPU_BENCH_FRAMES);
+        for(int kernel = 0; kernel < NUM_PIXEL_KERNELS; kernel++){
+            if(!pixelRowKernelSupported(kernel)){
+                printf("  %-8s not supported\n", pixelRowKernelName(kernel));
+                continue;
+            }
+            printf("  %-8s %.0f ns/frame\n", pixelRowKernelName(kernel), gameboy->benchmarkScanlines(kernel, PPU_BENCH_FRAMES));
+        }
+    }
+
+    if(!traceFilename.empty()){
+        gameboy->dumpTrace(traceFilename);
+    }
+    gameboy->dumpMemoryProfile();
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "blockcache.hh"
+#include "memory.hh"
+#include "cartridge.hh"
+
+#include <cstring>
+
+BlockCache::BlockCache(Memory *memory, Cartridge *cartridge){
+    this->memory = memory;
+    this->cartridge = cartridge;
+}
+
+CodeBlock *BlockCache::lookup(uint16_t address){
+    if(!stalePages.empty()){
+        purgeStalePages();
+    }
+
+    std::unordered_map<uint32_t, CodeBlock> *blocks;
+    uint32_t key = address;
+    // a block may not run past the end of the region it starts in
+    uint16_t regionEnd;
+
+    if(memory->dmaActive && address < IO_START){
+        // the cpu reads 0xFF from everything but IO and HRAM during OAM DMA
+        return nullptr;
+    }
+    else if(address < 0x4000){
+        blocks = &romBlocks;
+        regionEnd = 0x4000;
+    }
+    else if(address < 0x8000){
+        blocks = &romBlocks;
+        key |= (uint32_t) cartridge->getRomBank() << 16;
+        regionEnd = 0x8000;
+    }
+    else if(address >= 0xC000 && address < 0xE000){
+        blocks = &ramBlocks;
+        regionEnd = 0xE000;
+    }
+    else if(address >= 0xFF80 && address < 0xFFFF){
+        blocks = &ramBlocks;
+        regionEnd = 0xFFFF;
+    }
+    else{
+        // vram, external ram, echo ram, oam and io are always interpreted
+        return nullptr;
+    }
+
+    RecentBlock &slot = recent[recentSlot(key)];
+    if(slot.block && slot.key == key){
+        return slot.block;
+    }
+
+    std::unordered_map<uint32_t, CodeBlock>::iterator found = blocks->find(key);
+    if(found != blocks->end()){
+        slot = {key, &found->second};
+        return &found->second;
+    }
+
+    CodeBlock block;
+    if(!decode(address, regionEnd, block)){
+        return nullptr;
+    }
+
+    if(blocks == &ramBlocks){
+        for(uint32_t page = block.startAddress >> 8; page <= (uint32_t) (block.endAddress - 1) >> 8; page++){
+            markCode(page, true);
+        }
+    }
+
+    blocksDecoded++;
+    CodeBlock &cached = (*blocks)[key];
+    cached = std::move(block);
+    slot = {key, &cached};
+    return &cached;
+}
+
+bool BlockCache::decode(uint16_t address, uint16_t regionEnd, CodeBlock &block){
+    block.startAddress = address;
+    uint32_t curr = address;
+
+    while(block.instructions.size() < MAX_BLOCK_INSTRUCTIONS){
+        uint8_t opCode = memory->readByte(curr);
+        const OpcodeInfo &info = opcodeTable[opCode];
+        // the prefixed opcode is fetched like an operand
+        uint8_t length = opCode == 0xCB ? 2 : info.length;
+
+        // instructions that straddle the end of the region are left to the interpreter
+        if(curr + length > regionEnd){
+            break;
+        }
+
+        DecodedInstruction instruction = {opCode, length, {0, 0}};
+        for(int i = 1; i < length; i++){
+            instruction.operands[i - 1] = memory->readByte(curr + i);
+        }
+        block.instructions.push_back(instruction);
+        curr += length;
+
+        if(info.controlFlow){
+            break;
+        }
+    }
+
+    block.endAddress = curr;
+    return !block.instructions.empty();
+}
+
+void BlockCache::invalidatePage(uint8_t page){
+    markCode(page, false);
+    stalePages.push_back(page);
+    generation++;
+}
+
+// memory sends writes to pages with code through its slow path, which invalidates them
+void BlockCache::markCode(uint8_t page, bool code){
+    if(codeInPage[page] != code){
+        codeInPage[page] = code;
+        memory->protectPage(page, code);
+    }
+}
+
+void BlockCache::romBankChanged(){
+    // blocks stay cached under their own bank, the cpu only needs to look again
+    generation++;
+}
+
+// the block the cpu is in might not be readable anymore, make it go through lookup
+void BlockCache::forceLookup(){
+    generation++;
+}
+
+void BlockCache::purgeStalePages(){
+    for(std::unordered_map<uint32_t, CodeBlock>::iterator it = ramBlocks.begin(); it != ramBlocks.end();){
+        bool stale = false;
+        for(uint8_t page : stalePages){
+            if((it->second.startAddress >> 8) <= page && page <= ((it->second.endAddress - 1) >> 8)){
+                stale = true;
+                break;
+            }
+        }
+
+        if(stale){
+            it = ramBlocks.erase(it);
+        }
+        else{
+            it++;
+        }
+    }
+
+    // blocks that survived still mark their pages
+    for(std::pair<const uint32_t, CodeBlock> &entry : ramBlocks){
+        for(uint32_t page = entry.second.startAddress >> 8; page <= (uint32_t) (entry.second.endAddress - 1) >> 8; page++){
+            markCode(page, true);
+        }
+    }
+
+    stalePages.clear();
+    memset(recent, 0, sizeof(recent));
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+
+#include "opcodes.hh"
+
+class Memory;
+class Cartridge;
+class CPU;
+
+// longest run of instructions decoded into one block
+#define MAX_BLOCK_INSTRUCTIONS 64
+
+// entries in the direct mapped table in front of the hash maps, a power of 2
+#define RECENT_BLOCKS 1024
+
+/**
+ * @brief
+ * One pre-decoded instruction. Immediate operands are copied out of memory
+ * when the block is decoded, so executing it never has to fetch again.
+ * For CB prefixed instructions operands[0] holds the prefixed opcode.
+ */
+struct DecodedInstruction{
+    uint8_t opCode;
+    uint8_t length;
+    uint8_t operands[2];
+};
+
+// native code generated by the jit, runs straight through and returns
+typedef void (*NativeCode)(CPU *cpu);
+
+/**
+ * @brief
+ * Consecutive instructions of a block compiled to native code. The run never
+ * branches, so the cycles it takes and where it leaves the program counter are
+ * known when it is compiled.
+ */
+struct NativeRun{
+    NativeCode code;
+    uint8_t instructionCount;
+    // bytes of gameboy code the run covers
+    uint8_t length;
+    uint8_t cycles;
+};
+
+/**
+ * @brief
+ * Straight line run of instructions starting at startAddress, ending at the
+ * first instruction that can change control flow.
+ */
+struct CodeBlock{
+    uint16_t startAddress;
+    uint16_t endAddress;
+    std::vector<DecodedInstruction> instructions;
+
+    // times the block has been entered while the jit is on, it gets compiled once it is hot
+    uint32_t executions = 0;
+    // jit generation nativeRuns were compiled in, the code is stale once the jit moves on
+    uint32_t nativeGeneration = 0;
+    std::vector<NativeRun> nativeRuns;
+    // index into nativeRuns of the run starting at each instruction, -1 if none does
+    std::vector<int8_t> nativeRunAt;
+};
+
+/**
+ * @brief
+ * Cache of decoded blocks keyed by address and, for the switchable rom area,
+ * the rom bank the block was decoded from. Only rom, WRAM and HRAM are cached.
+ * Writing to a RAM page that holds a block drops every block on that page.
+ */
+class BlockCache{
+    public:
+        // bumped whenever a block the cpu might be holding on to goes away or the rom bank changes
+        uint32_t generation = 0;
+        // ram pages (address >> 8) that currently hold decoded blocks
+        bool codeInPage[256] = {false};
+
+        BlockCache(Memory *memory, Cartridge *cartridge);
+
+        CodeBlock *lookup(uint16_t address);
+        void invalidatePage(uint8_t page);
+        void romBankChanged();
+        void forceLookup();
+
+        uint64_t blocksDecoded = 0;
+
+    private:
+        Memory *memory;
+        Cartridge *cartridge;
+
+        std::unordered_map<uint32_t, CodeBlock> romBlocks;
+        std::unordered_map<uint32_t, CodeBlock> ramBlocks;
+
+        // the last block looked up under each slot, checked before the hash maps. Blocks in
+        // the maps never move, the table is only emptied when blocks are erased
+        struct RecentBlock{
+            uint32_t key;
+            CodeBlock *block;
+        };
+        RecentBlock recent[RECENT_BLOCKS] = {};
+
+        int recentSlot(uint32_t key){
+            // the rom bank sits above bit 16 of the key, fold it into the slot
+            return (key ^ ((key >> 16) * 0x9E)) & (RECENT_BLOCKS - 1);
+        }
+
+        // invalidated pages are only purged on the next lookup, the instruction that
+        // wrote to them might still be reading operands out of one of their blocks
+        std::vector<uint8_t> stalePages;
+
+        void purgeStalePages();
+        void markCode(uint8_t page, bool code);
+        bool decode(uint16_t address, uint16_t regionEnd, CodeBlock &block);
+};
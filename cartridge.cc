@@ -2,19 +2,11 @@
 
 Cartridge::Cartridge(std::string filename){
     //printf("filename... %s\n", filename.c_str());
-    std::ifstream GB_ROM(filename, std::ios::binary);
-    
-    if(GB_ROM.fail()){
-        std::cout << "could not open file... :(" << std::endl;
-    }
-
-    GB_ROM.seekg(0, std::ios::end);
-    this->fileSize = GB_ROM.tellg();
-    GB_ROM.seekg(0, std::ios::beg);
-
-    //printf("filesize: %d\n", fileSize);
+    this->filename = filename;
+    this->image = RomImage::open(filename);
+    this->rom = image->data;
+    this->fileSize = image->size;
 
-    GB_ROM.read((char *)this->rom, fileSize);
     // memset(&ramBanks, 0, sizeof(ramBanks));
     this->getRomBanks();
     this->getRamBanks();
@@ -23,6 +15,14 @@ Cartridge::Cartridge(std::string filename){
     printInfo();
 }
 
+// the rtc is written out with the rest of the save, the sync thread is stopped and the file unmapped
+Cartridge::~Cartridge(){
+    if(saveFile){
+        updateSave();
+        saveFile.reset();
+    }
+}
+
 void Cartridge::printInfo(){
     // title
     std::string title = "";
@@ -41,12 +41,100 @@ void Cartridge::printInfo(){
     std::cout << "mbc type: " << this->mbcNum << std::endl;
 }
 
-uint8_t Cartridge::readCartridge(uint16_t address){
-    return this->mbc->readMemory(address);
+const char *Cartridge::getMBCName(){
+    return std::visit([](auto &controller){ return controller.name; }, mbc);
+}
+
+// the rtc of an MBC3 reads the time off the emulated cycle counter
+void Cartridge::setClock(const uint64_t *clock){
+    if(MBC3 *mbc3 = std::get_if<MBC3>(&mbc)){
+        mbc3->setClock(clock);
+    }
+}
+
+// battery backed state: the external ram, then the rtc for cartridges that have one
+size_t Cartridge::getSaveSize(){
+    return std::visit([](auto &controller){ return controller.saveSize(); }, mbc);
+}
+
+void Cartridge::saveBattery(uint8_t *out){
+    std::visit([out](auto &controller){ controller.save(out); }, mbc);
+}
+
+void Cartridge::loadBattery(const uint8_t *in, size_t size){
+    std::visit([in, size](auto &controller){ controller.load(in, size); }, mbc);
+}
+
+// the rom's name with its extension swapped for .sav, next to the rom
+std::string Cartridge::savePath(){
+    size_t dot = filename.find_last_of('.');
+    size_t slash = filename.find_last_of('/');
+    if(dot == std::string::npos || (slash != std::string::npos && dot < slash)){
+        return filename + ".sav";
+    }
+    return filename.substr(0, dot) + ".sav";
+}
+
+/**
+ * @brief
+ * Put the external ram of a battery backed cartridge onto its save file. The
+ * ram already in the file becomes the cartridge's ram, only an rtc has to be
+ * read out of it. Returns false if the cartridge has nothing to save or the
+ * file couldn't be mapped, the ram then stays in memory like before.
+ */
+bool Cartridge::attachSaveFile(int syncIntervalMs){
+    size_t size = getSaveSize();
+    if(!hasBattery || size == 0 || saveFile){
+        return false;
+    }
+
+    saveFile = std::make_unique<SaveFile>(savePath(), size, syncIntervalMs);
+    if(!saveFile->data){
+        saveFile.reset();
+        return false;
+    }
+
+    std::visit([this](auto &controller){ controller.useRAM(saveFile->data); }, mbc);
+    if(saveFile->existingSize > 0){
+        loadBattery(saveFile->data, saveFile->existingSize);
+    }
+    return true;
+}
+
+/**
+ * @brief
+ * A write to a cartridge with a save file. The save is only marked dirty if a
+ * byte of ram really changed, and the rtc footer is only brought up to date
+ * when the game latches or sets the clock.
+ */
+void Cartridge::writeSaved(uint16_t address, uint8_t data){
+    bool ram = address >= 0xA000 && address < 0xC000;
+    uint8_t before = ram ? readCartridge(address) : 0;
+    std::visit([address, data](auto &controller){ controller.writeMemory(address, data); }, mbc);
+
+    MBC3 *mbc3 = std::get_if<MBC3>(&mbc);
+    if(mbc3 && mbc3->hasTimer && ((address >= 0x6000 && address < 0x8000) || (ram && mbc3->rtcSelected()))){
+        updateSave();
+    }
+    else if(ram && readCartridge(address) != before){
+        saveFile->markDirty();
+    }
 }
 
-void Cartridge::writeCartridge(uint16_t address, uint8_t data){
-    this->mbc->writeMemory(address, data);
+// the rtc isn't in the ram the game writes to, so copy it into the save when it has moved on
+void Cartridge::updateSave(){
+    MBC3 *mbc3 = std::get_if<MBC3>(&mbc);
+    if(!saveFile || !mbc3 || !mbc3->hasTimer){
+        return;
+    }
+
+    uint8_t *footer = saveFile->data + mbc3->MBC::saveSize();
+    uint8_t previous[RTC_SAVE_SIZE];
+    memcpy(previous, footer, RTC_SAVE_SIZE);
+    mbc3->saveRTC(footer);
+    if(memcmp(previous, footer, RTC_SAVE_SIZE) != 0){
+        saveFile->markDirty();
+    }
 }
 
 void Cartridge::getMBC(){
@@ -55,23 +143,53 @@ void Cartridge::getMBC(){
     switch (mbcType)
     {
     case 0x00:
-        this->mbc = new MBC0(this->rom);
+        this->mbc = MBC0(this->rom);
         this->mbcNum = 0;
         break;
     case 0x01:
         std::cout << "CREATING DAT MBC1"   << std::endl;
-        this->mbc = new MBC1(this->rom, false, this->numRamBanks, this->numRomBanks);
+        this->mbc.emplace<MBC1>(this->rom, false, this->numRamBanks, this->numRomBanks);
         this->mbcNum = 1;
         break;
     case 0x02:
-        this->mbc = new MBC1(this->rom, false, this->numRamBanks, this->numRomBanks);
+        this->mbc.emplace<MBC1>(this->rom, false, this->numRamBanks, this->numRomBanks);
         this->mbcNum = 1;
         break;
     case 0x03:
-        this->mbc = new MBC1(this->rom, true, this->numRamBanks, this->numRomBanks);
+        this->mbc.emplace<MBC1>(this->rom, true, this->numRamBanks, this->numRomBanks);
         this->mbcNum = 1;
+        this->hasBattery = true;
+        break;
+    case 0x0F:
+    case 0x10:
+        // with the rtc
+        this->mbc.emplace<MBC3>(this->rom, true, true, mbcType == 0x10 ? this->numRamBanks : 0, this->numRomBanks);
+        this->mbcNum = 3;
+        this->hasBattery = true;
+        break;
+    case 0x11:
+    case 0x12:
+    case 0x13:
+        this->mbc.emplace<MBC3>(this->rom, mbcType == 0x13, false, mbcType == 0x11 ? 0 : this->numRamBanks, this->numRomBanks);
+        this->mbcNum = 3;
+        this->hasBattery = mbcType == 0x13;
+        break;
+    case 0x19:
+    case 0x1A:
+    case 0x1B:
+    case 0x1C:
+    case 0x1D:
+    case 0x1E:
+        // 0x1C-0x1E have a rumble motor, 0x1B and 0x1E a battery
+        this->mbc.emplace<MBC5>(this->rom, mbcType == 0x1B || mbcType == 0x1E, mbcType >= 0x1C,
+            (mbcType == 0x19 || mbcType == 0x1C) ? 0 : this->numRamBanks, this->numRomBanks);
+        this->mbcNum = 5;
+        this->hasBattery = mbcType == 0x1B || mbcType == 0x1E;
         break;
     default:
+        // not supported yet, run it as a plain rom
+        std::cout << "unsupported mbc, running without one" << std::endl;
+        this->mbc = MBC0(this->rom);
         break;
     }
 }
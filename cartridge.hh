@@ -1,12 +1,13 @@
 #pragma once
 
 #include <iostream>
-#include <fstream>
 #include <string>
+#include <memory>
+#include <variant>
 
 #include "mbc.hh"
-
-#define MAX_GAME_SIZE 0x200000
+#include "romimage.hh"
+#include "savefile.hh"
 
 #define MBC_ADDRESS 0x147
 #define ROM_SIZE_ADDRESS 0x148
@@ -21,22 +22,53 @@ class Cartridge{
 
         bool ramBankEnabled = false;
         bool romBankEnabled = false;
-        uint8_t rom[MAX_GAME_SIZE];
+        // shared with every other cartridge running the same rom
+        std::shared_ptr<RomImage> image;
+        const uint8_t *rom;
+        std::string filename;
+        // battery backed ram mapped onto <rom>.sav, null until a save is attached
+        std::unique_ptr<SaveFile> saveFile;
 
-        bool hasBattery;
+        bool hasBattery = false;
         bool hasSave;
 
         // if false, then it is in simple mode, otherwise advanced
         bool bankMode = false;
 
         Cartridge(std::string filename);
+        ~Cartridge();
         void printInfo();
-        uint8_t readCartridge(uint16_t address);
-        void writeCartridge(uint16_t address, uint8_t data);
+        const char *getMBCName();
+        void setClock(const uint64_t *clock);
+
+        size_t getSaveSize();
+        void saveBattery(uint8_t *out);
+        void loadBattery(const uint8_t *in, size_t size);
+        bool attachSaveFile(int syncIntervalMs);
+        void updateSave();
+        std::string savePath();
+
+        // the controller is picked once when the rom is loaded, these compile down to a switch on it
+        uint8_t readCartridge(uint16_t address){
+            return std::visit([address](auto &controller){ return controller.readMemory(address); }, mbc);
+        }
+
+        void writeCartridge(uint16_t address, uint8_t data){
+            if(saveFile){
+                writeSaved(address, data);
+                return;
+            }
+            std::visit([address, data](auto &controller){ controller.writeMemory(address, data); }, mbc);
+        }
+
+        uint16_t getRomBank(){
+            return std::visit([](auto &controller){ return controller.currRomBank; }, mbc);
+        }
     
     private:
-        MBC *mbc;
+        std::variant<MBC0, MBC1, MBC3, MBC5> mbc = MBC0(nullptr);
         void getMBC();
         void getRomBanks();
         void getRamBanks();
+        void writeSaved(uint16_t address, uint8_t data);
 };
\ No newline at end of file
@@ -5,6 +5,11 @@
 #include "memory.hh"
 #include "interrupt.hh"
 #include "timer.hh"
+#include "trace.hh"
+#include "opcodes.hh"
+#include "blockcache.hh"
+#include "jit.hh"
+#include "scheduler.hh"
 
 #define FLAGS RegAF.lo
 
@@ -13,6 +18,32 @@
 #define FLAG_H 5
 #define FLAG_C 4
 
+// what the last alu op was when flags are evaluated lazily, see CPU::deferFlags
+#define LAZY_NONE 0
+#define LAZY_ADD 1
+#define LAZY_SUB 2
+#define LAZY_INC 3
+#define LAZY_DEC 4
+// Z from the result, N and H clear, C as recorded
+#define LAZY_LOGIC 5
+// same as LAZY_LOGIC with H set
+#define LAZY_AND 6
+// RLA RLCA RRA RRCA, like LAZY_LOGIC but Z is always clear
+#define LAZY_ROTATE_A 7
+
+// first CB prefixed operation (opcode >> 3) of each bit instruction, followed by one per bit
+#define PREFIX_BIT 8
+#define PREFIX_RES 16
+#define PREFIX_SET 24
+
+// longest polling loop idle loop detection looks at
+#define MAX_IDLE_LOOP_BYTES 16
+
+// CPU::sweepOpcode numbers the CB prefixed instructions after the 256 unprefixed ones
+#define SWEEP_OPCODES 512
+// where the sweep puts the instructions it runs, the registers it points at memory stay clear of it
+#define SWEEP_CODE 0xC000
+
 #define VBLANK 0
 #define LCD 1
 #define TIMER 2
@@ -40,58 +71,35 @@ class CPU{
 
         bool lastInstructionEI = false;
 
-        uint8_t nonprefixTimings[256] = {
-            4, 12, 8, 8, 4, 4, 8, 4, 20, 8, 8, 8, 4, 4, 8, 4, 
-            4, 12, 8, 8, 4, 4, 8, 4, 12, 8, 8, 8, 4, 4, 8, 4, 
-            0, 12, 8, 8, 4, 4, 8, 4, 0, 8, 8, 8, 4, 4, 8, 4, 
-            0, 12, 8, 8, 12, 12, 12, 4, 0, 8, 8, 8, 4, 4, 8, 4, 
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, 
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, 
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, 
-            8, 8, 8, 8, 8, 8, 4, 8, 4, 4, 4, 4, 4, 4, 8, 4, 
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, 
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, 
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, 
-            4, 4, 4, 4, 4, 4, 8, 4, 4, 4, 4, 4, 4, 4, 8, 4, 
-            0, 12, 0, 16, 0, 16, 8, 16, 0, 16, 0, 4, 0, 24, 8, 16, 
-            0, 12, 0, 0, 0, 16, 8, 16, 0, 16, 0, 0, 0, 0, 8, 16, 
-            12, 12, 8, 0, 0, 16, 8, 16, 16, 4, 16, 0, 0, 0, 8, 16, 
-            12, 12, 8, 4, 0, 16, 8, 16, 12, 8, 16, 4, 0, 0, 8, 16
-        };
-
-        uint8_t prefixTimings[256] = {
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, 
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, 
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, 
-            8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, 
-            8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8
-        };
+        // number of instructions executed, halted cycles are not counted
+        uint64_t instructionCount = 0;
 
         CPU(Memory *memory, Interrupt *interrupt, Timer *timer);
 
-        bool debugMode = false;
+        Tracer tracer;
 
-        void debugPrint(std::string str);
         void toggleDebugMode(bool val);
+        void traceInstruction(TraceRecord *record);
 
         bool halt = false;
         bool haltBug = false;
 
+        // decoded blocks to execute from, nullptr to fetch every instruction from memory
+        BlockCache *blockCache = nullptr;
+        // compiles hot blocks to native code, only used together with the block cache
+        JIT *jit = nullptr;
+
         uint8_t step();
+        uint8_t stepCached();
+        uint8_t executeCached();
+        uint16_t runBlock(Scheduler *scheduler, uint64_t updateEnd);
 
         uint8_t executeOP(uint8_t opCode);
         uint8_t executePrefixOP(uint8_t opCode);
+
+        template<uint8_t opCode> void prefixOP();
+        template<uint8_t operation> void prefixOperation(uint8_t &val);
+        template<uint8_t operand> uint8_t &prefixOperand();
         uint8_t getFlag(uint8_t flag);
         void setFlag(uint8_t flag, uint8_t val);
         
@@ -102,6 +110,18 @@ class CPU{
 
         void resetFlags();
 
+#ifdef LAZY_FLAGS
+        // F is only up to date after this, anything reading it directly has to call it first
+        void materializeFlags();
+        void deferFlags(uint8_t op, uint8_t a, uint8_t b, uint8_t carry);
+        uint8_t lazyFlag(uint8_t flag);
+
+        uint8_t lazyOp = LAZY_NONE;
+        uint8_t lazyA = 0;
+        uint8_t lazyB = 0;
+        uint8_t lazyCarry = 0;
+#endif
+
         void add8(uint8_t &a, uint8_t b);
         void add16(uint16_t &a, uint16_t b);
         void adc(uint8_t &a, uint8_t b);
@@ -117,6 +137,10 @@ class CPU{
 
         void cp(uint8_t a, uint8_t b);
 
+        void and8(uint8_t &a, uint8_t b);
+        void xor8(uint8_t &a, uint8_t b);
+        void or8(uint8_t &a, uint8_t b);
+
         void rl(uint8_t &reg);
         void rlc(uint8_t &reg);
         void rla();
@@ -138,14 +162,46 @@ class CPU{
         void set(uint8_t n, uint8_t &reg);
         void res(uint8_t n, uint8_t &reg);
 
+        int idleLoopCycles(uint16_t start, uint16_t branchAddress, int &instructions);
+        bool runIdleIteration(uint16_t start, uint16_t branchAddress);
+
         void handleInterrupts();
         void interruptServiceRoutine(uint8_t interruptCode);
 
         void test();
+        uint64_t sweepOpcode(uint16_t opcode, int samples);
 
     private:
         Memory *memory;
         Interrupt *interrupt;
         Timer *timer;
+
+        CodeBlock *currentBlock = nullptr;
+        size_t blockIndex = 0;
+        // where the next instruction of currentBlock lives
+        uint16_t blockPC = 0;
+        uint32_t blockGeneration = 0;
+
+        // still part way through currentBlock, nothing has jumped away or made it stale
+        bool inBlock(){
+            return currentBlock != nullptr && programCounter == blockPC && blockGeneration == blockCache->generation && blockIndex < currentBlock->instructions.size();
+        }
+
+        // immediate operands of the cached instruction being executed, nullptr when fetching from memory
+        const uint8_t *operands = nullptr;
+
+        uint8_t fetchByte(){
+            if(operands){
+                programCounter++;
+                return *operands++;
+            }
+            return memory->readByte(programCounter++);
+        }
+
+        uint16_t fetchWord(){
+            uint16_t lo = fetchByte();
+            uint16_t hi = fetchByte();
+            return lo | (hi << 8);
+        }
         
 };
@@ -1,8 +1,12 @@
 #include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <csignal>
 
 #include "gameboy.hh"
 
 Gameboy::Gameboy(std::string filename){
+#ifndef HEADLESS
     SDL_Init(SDL_INIT_VIDEO);
     window = SDL_CreateWindow(
         "Game Mandem",
@@ -15,27 +19,405 @@ Gameboy::Gameboy(std::string filename){
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
     texture = SDL_CreateTexture(
         renderer,
-        SDL_PIXELFORMAT_RGBA4444,
+        // r, g, b, a bytes in memory order, the same layout as the ppu's Colour
+        SDL_PIXELFORMAT_RGBA32,
         SDL_TEXTUREACCESS_STREAMING,
         160,
         144
     );
+#endif
 
     cartridge = new Cartridge(filename);
+#ifndef HEADLESS
     joypad = new Joypad(window, texture, renderer);
-    memory = new Memory(cartridge, joypad);
+#else
+    joypad = new Joypad();
+#endif
+    scheduler = new Scheduler();
+    memory = new Memory(cartridge, joypad, scheduler);
     interrupt = new Interrupt(memory);
-    timer = new Timer(memory, interrupt);
+    timer = new Timer(memory, interrupt, scheduler);
     cpu = new CPU(memory, interrupt, timer);
-    ppu = new PPU(memory, interrupt);
+    ppu = new PPU(memory, interrupt, scheduler);
 
+    timer->reschedule();
+    ppu->start();
+    cartridge->setClock(&scheduler->now);
+
+    // fetching an instruction is one page table read, decoding ahead of time doesn't win that
+    // back, so the cache is only on when asked for or under the jit
+    blockCache = new BlockCache(memory, cartridge);
+    toggleBlockCache(false);
 }
 
 void Gameboy::toggleDebugMode(bool val){
     cpu->toggleDebugMode(val);
 }
 
+void Gameboy::dumpTrace(std::string filename){
+    if(cpu->tracer.recordCount > 0 && cpu->tracer.dump(filename)){
+        std::cout << "wrote instruction trace to " << filename << std::endl;
+    }
+}
+
+#ifdef MEMORY_PROFILE
+// bumped by SIGUSR1, every gameboy profiling memory dumps once it sees the count go up
+static volatile sig_atomic_t memoryProfileRequests = 0;
+
+static void requestMemoryProfile(int){
+    memoryProfileRequests = memoryProfileRequests + 1;
+}
+#endif
+
+/**
+ * @brief
+ * Write the memory access counts to filename when dumpMemoryProfile is called
+ * and whenever the process gets SIGUSR1. Only does anything in a build made
+ * with MEMORY_PROFILE.
+ */
+bool Gameboy::profileMemory(std::string filename){
+#ifdef MEMORY_PROFILE
+    memoryProfileFilename = filename;
+    memoryProfileRequestsSeen = memoryProfileRequests;
+    signal(SIGUSR1, requestMemoryProfile);
+    return true;
+#else
+    (void) filename;
+    std::cout << "memory profiling isn't compiled in, build with MEMORY_PROFILE=1" << std::endl;
+    return false;
+#endif
+}
+
+bool Gameboy::dumpMemoryProfile(){
+#ifdef MEMORY_PROFILE
+    if(!memoryProfileFilename.empty() && memory->profile.dump(memoryProfileFilename)){
+        std::cout << "wrote memory profile to " << memoryProfileFilename << std::endl;
+        return true;
+    }
+#endif
+    return false;
+}
+
+void Gameboy::toggleBlockCache(bool val){
+    memory->blockCache = val ? blockCache : nullptr;
+    cpu->blockCache = val ? blockCache : nullptr;
+    if(!val){
+        // the jit compiles out of the block cache
+        cpu->jit = nullptr;
+    }
+}
+
+/**
+ * @brief
+ * Switch the jit on or off, it sits on top of the block cache so turning it on
+ * turns the block cache on too. Returns false if this host can't run it.
+ */
+bool Gameboy::toggleJIT(bool val){
+    if(!val){
+        cpu->jit = nullptr;
+        return true;
+    }
+
+#ifndef JIT_SUPPORTED
+    std::cout << "the jit only runs on x86-64, staying on the interpreter" << std::endl;
+    return false;
+#else
+    if(jit == nullptr){
+        jit = new JIT(cpu);
+    }
+    if(!jit->available()){
+        return false;
+    }
+
+    toggleBlockCache(true);
+    cpu->jit = jit;
+    return true;
+#endif
+}
+
+uint64_t Gameboy::getJITRunsCompiled(){
+    return jit ? jit->runsCompiled : 0;
+}
+
+const char *Gameboy::getMBCName(){
+    return cartridge->getMBCName();
+}
+
+void Gameboy::toggleHaltFastForward(bool val){
+    haltFastForward = val;
+}
+
+void Gameboy::toggleIdleLoopSkip(bool val){
+    idleLoopSkip = val;
+}
+
+/**
+ * @brief
+ * Fire every event that came due with the instruction that just finished.
+ */
+void Gameboy::runEvents(){
+    int event;
+    while((event = scheduler->popDue()) >= 0){
+        switch(event){
+            case EVENT_TIMER:
+                // catches TIMA up, which overflows it
+                timer->sync();
+                timer->reschedule();
+                break;
+            case EVENT_PPU:
+                ppu->transition();
+                break;
+            case EVENT_JOYPAD_POLL:
+                // polled after interrupts are handled, same as it always was
+                keyPollDue = scheduler->now == nextKeyPoll;
+                while(nextKeyPoll <= scheduler->now){
+                    nextKeyPoll += KEY_POLL_CYCLES;
+                }
+                scheduler->schedule(EVENT_JOYPAD_POLL, nextKeyPoll);
+                break;
+            case EVENT_DMA:
+                memory->finishDMA();
+                break;
+        }
+    }
+}
+
+/**
+ * @brief
+ * Run the cpu on its own up to the next event or the end of the update,
+ * whichever comes first. Nothing outside the cpu can change before then, so
+ * between instructions there is only the interrupt check, and only when
+ * something made one due. Returns after the instruction that reaches the
+ * deadline, with the address it started at, and update does the rest.
+ */
+uint16_t Gameboy::runCPU(uint64_t updateEnd){
+    while(true){
+        uint16_t pcBefore = cpu->programCounter;
+        if(haltFastForward && cpu->halt && !cpu->lastInstructionEI){
+            // only an interrupt wakes the cpu, so go straight to the next thing that can raise one
+            int cyclesAdded = haltCycles(updateEnd);
+            haltCyclesSkipped += cyclesAdded - 4;
+            scheduler->now += cyclesAdded;
+        }
+        else if(cpu->blockCache){
+            // a whole block per dispatch, it stops by itself wherever the checks below are needed
+            pcBefore = cpu->runBlock(scheduler, updateEnd);
+        }
+        else{
+            scheduler->now += cpu->step();
+        }
+
+        // the instruction can move the deadline too, writing the timer, LCDC or DMA
+        if(scheduler->now >= std::min(scheduler->nextDeadline, updateEnd)){
+            return pcBefore;
+        }
+
+        if(memory->interruptCheckDue){
+            cpu->handleInterrupts();
+        }
+
+        checkIdleLoop(pcBefore, updateEnd);
+    }
+}
+
+// a short backward branch might be a loop polling for the ppu or an interrupt
+void Gameboy::checkIdleLoop(uint16_t pcBefore, uint64_t updateEnd){
+    if(idleLoopSkip && cpu->programCounter < pcBefore && pcBefore - cpu->programCounter < MAX_IDLE_LOOP_BYTES && !cpu->halt && !cpu->lastInstructionEI && !cpu->tracer.enabled){
+        skipIdleLoop(pcBefore, updateEnd);
+    }
+}
+
+/**
+ * @brief
+ * Cycles until the next scheduled event or the end of the update, nothing
+ * outside the cpu can change before then.
+ */
+int Gameboy::cyclesToNextEvent(uint64_t updateEnd){
+    return std::min(scheduler->nextDeadline, updateEnd) - scheduler->now;
+}
+
+/**
+ * @brief
+ * Cycles a halted cpu can skip in one step. Stepping 4 cycles at a time would
+ * only see something happen at the next event, so stop at the first step that
+ * reaches it. Everything on the way is the same as stepping there 4 at a time.
+ */
+int Gameboy::haltCycles(uint64_t updateEnd){
+    int cycles = cyclesToNextEvent(updateEnd);
+
+    // round up to the step that gets there
+    return std::max(4, (cycles + 3) & ~3);
+}
+
+/**
+ * @brief
+ * The cpu just branched back from branchAddress. If that closed a polling loop
+ * (see CPU::idleLoopCycles), every iteration that finishes before the next
+ * event reads the same LY/STAT/IF and goes round again, so run one of them to
+ * get the registers it leaves behind and skip the time of the rest.
+ * Returns the cycles skipped.
+ */
+int Gameboy::skipIdleLoop(uint16_t branchAddress, uint64_t updateEnd){
+    uint16_t start = cpu->programCounter;
+    int instructions = 0;
+    int iterationCycles = cpu->idleLoopCycles(start, branchAddress, instructions);
+    if(iterationCycles == 0){
+        return 0;
+    }
+
+    // the last skipped iteration has to end before the event, landing on it would trigger it
+    int iterations = (cyclesToNextEvent(updateEnd) - 1) / iterationCycles;
+    if(iterations <= 0 || !cpu->runIdleIteration(start, branchAddress)){
+        return 0;
+    }
+
+    // the timer and ppu catch up on their own when they are next needed
+    int skipped = iterations * iterationCycles;
+    scheduler->now += skipped;
+
+    cpu->instructionCount += iterations * instructions;
+    idleCyclesSkipped += skipped;
+    return skipped;
+}
+
+/**
+ * @brief
+ * Keep the battery backed ram in <rom>.sav from now on. Call before the
+ * first update, the game picks up whatever ram the file already holds.
+ */
+bool Gameboy::enableBatterySave(int syncIntervalMs){
+    if(!cartridge->attachSaveFile(syncIntervalMs)){
+        return false;
+    }
+    std::cout << "saving to " << cartridge->savePath() << std::endl;
+    return true;
+}
+
+// write out the save now instead of waiting for the background sync, for when the emulator exits
+void Gameboy::flushBatterySave(){
+    if(cartridge->saveFile){
+        cartridge->updateSave();
+        cartridge->saveFile->sync();
+    }
+}
+
+/**
+ * @brief
+ * Draw the 144 visible lines over and over with the given pixel kernel and
+ * return the average ns a frame of them took. Only the ppu's rendering is
+ * timed, with whatever is in vram right now, and its state is put back after.
+ */
+double Gameboy::benchmarkScanlines(int kernel, int frames){
+    int previousKernel = ppu->pixelKernel;
+    uint8_t previousLine = memory->memory[LY];
+    bool previousWindowInLine = ppu->windowInLine;
+    ppu->setPixelKernel(kernel);
+
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+    for(int i = 0; i < frames; i++){
+        for(int line = 0; line < 144; line++){
+            memory->memory[LY] = line;
+            ppu->renderScanline();
+        }
+    }
+    std::chrono::time_point<std::chrono::steady_clock> end = std::chrono::steady_clock::now();
+
+    memory->memory[LY] = previousLine;
+    ppu->windowInLine = previousWindowInLine;
+    ppu->setPixelKernel(previousKernel);
+    return std::chrono::duration<double, std::nano>(end - start).count() / frames;
+}
+
+// see CPU::sweepOpcode, the gameboy is no good for anything else afterwards
+uint64_t Gameboy::sweepOpcode(uint16_t opcode, int samples){
+    return cpu->sweepOpcode(opcode, samples);
+}
+
+/**
+ * @brief
+ * Pick what the 4 shades look like, either by scheme name (grey, green,
+ * pocket) or as 4 comma separated rrggbb colours, lightest first. Returns
+ * false and leaves the shades alone if it can't make sense of it.
+ */
+bool Gameboy::setColourScheme(std::string scheme){
+    for(int i = 0; i < NUM_COLOUR_SCHEMES; i++){
+        if(scheme == PPU::colourSchemeName(i)){
+            ppu->setColourScheme(i);
+            return true;
+        }
+    }
+
+    Colour shades[4];
+    const char *curr = scheme.c_str();
+    for(int i = 0; i < 4; i++){
+        unsigned int rgb;
+        int length = 0;
+        if(sscanf(curr, "%6x%n", &rgb, &length) != 1 || length != 6){
+            return false;
+        }
+        shades[i] = {(uint8_t) (rgb >> 16), (uint8_t) (rgb >> 8), (uint8_t) rgb, 255};
+        curr += length;
+        if(*curr != (i == 3 ? '\0' : ',')){
+            return false;
+        }
+        curr++;
+    }
+    ppu->setShades(shades);
+    return true;
+}
+
+// rgba, shades or packed, see LCD_FORMAT_
+bool Gameboy::setLCDFormat(std::string format){
+    for(int i = 0; i < NUM_LCD_FORMATS; i++){
+        if(format == PPU::lcdFormatName(i)){
+            ppu->setLCDFormat(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *Gameboy::getLCDFormatName(){
+    return PPU::lcdFormatName(ppu->lcdFormat);
+}
+
+size_t Gameboy::getFrameSize(){
+    return ppu->frameSize();
+}
+
+/**
+ * @brief
+ * Have dirty track what changes in vram and oam, for caches outside the
+ * emulator. It's the caller's to read and clear, the ppu keeps its own.
+ */
+void Gameboy::watchVideo(VideoDirty *dirty){
+    memory->watchVideo(dirty);
+}
+
+void Gameboy::unwatchVideo(VideoDirty *dirty){
+    memory->unwatchVideo(dirty);
+}
+
+// FNV-1a over the frame as the ppu stores it, the smaller the format the cheaper
+uint64_t Gameboy::frameHash(){
+    const uint8_t *data = ppu->frameData();
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < ppu->frameSize(); i++){
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t Gameboy::getInstructionCount(){
+    return cpu->instructionCount;
+}
+
 void Gameboy::renderScreen(){
+#ifdef HEADLESS
+    // nothing to present and no frame cap when running headless
+    ppu->drawLCD = false;
+#else
     std::chrono::time_point<std::chrono::system_clock> currTime = std::chrono::system_clock::now();
 
     std::chrono::duration<double, std::milli> elapsedTime = currTime - lastFrameTime;
@@ -45,72 +427,136 @@ void Gameboy::renderScreen(){
     }
 
     lastFrameTime = std::chrono::system_clock::now();
-    std::vector<uint16_t> pixels;
-
-    for(int i = 0; i < 144; i++){
-        for(int j = 0; j < 160; j++){
-            //printf("(%d, %d, %d, %d), ", ppu->lcd[i][j].r, ppu->lcd[i][j].g, ppu->lcd[i][j].b, ppu->lcd[i][j].a);
-            uint8_t r = ppu->lcd[i][j].r >> 4;
-            uint8_t g = ppu->lcd[i][j].g >> 4;
-            uint8_t b = ppu->lcd[i][j].b >> 4;
-            uint8_t a = ppu->lcd[i][j].a >> 4;
-            
-            uint16_t combinedColour = (r << 12) | (g << 8) | (b << 4) | a;
-            pixels.push_back(combinedColour);
-            
-        }   
-    }
-    SDL_UpdateTexture(texture, nullptr, pixels.data(), 160 * 2);
+
+    // the ppu draws rgba into lcd in the texture's own format, presenting it is only the upload
+    std::chrono::time_point<std::chrono::steady_clock> presentStart = std::chrono::steady_clock::now();
+    if(ppu->lcd){
+        SDL_UpdateTexture(texture, nullptr, ppu->lcd, sizeof(ppu->lcd[0]));
+    }
+    else{
+        // the indexed formats only become colours here, straight into the texture
+        void *pixels;
+        int pitch;
+        if(SDL_LockTexture(texture, nullptr, &pixels, &pitch) == 0){
+            ppu->convertFrame((Colour *) pixels, pitch);
+            SDL_UnlockTexture(texture);
+        }
+    }
     SDL_RenderCopy(renderer, texture, nullptr, nullptr);
     SDL_RenderPresent(renderer);
+    presentNanoseconds += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - presentStart).count();
+    framesPresented++;
     ppu->drawLCD = false;
+#endif
 }
 
 void Gameboy::update(){
-    // execution loop
-    int cyclesThisUpdate = 0;
+    // execution loop, runs until the first instruction to end MAX_CYCLE cycles in
+    uint64_t updateEnd = scheduler->now + MAX_CYCLE;
+    nextKeyPoll = scheduler->now + KEY_POLL_CYCLES;
+    scheduler->schedule(EVENT_JOYPAD_POLL, nextKeyPoll);
 
-    while (cyclesThisUpdate < MAX_CYCLE){
-        int cyclesAdded = cpu->step();
+    while (scheduler->now < updateEnd){
+        uint16_t pcBefore = runCPU(updateEnd);
 
-        cyclesThisUpdate += cyclesAdded;
-
-        // update timer registers
-        timer->incrementDIV(cyclesAdded);
-
-        if(timer->clockEnabled()){
-            timer->incrementTIMA(cyclesAdded);
+        // the timer and ppu only do anything when one of their events comes due
+        if(scheduler->now >= scheduler->nextDeadline){
+            runEvents();
         }
 
-        ppu->step(cyclesAdded);
-
-        cpu->handleInterrupts();
+        if(memory->interruptCheckDue){
+            cpu->handleInterrupts();
+        }
 
-        if(cyclesThisUpdate % 5000 == 0){
+        if(keyPollDue){
+            keyPollDue = false;
             joypad->keyPoll();
         }
 
-        
-
         if(ppu->drawLCD){
             renderScreen();
             frame++;
         }
+
+        checkIdleLoop(pcBefore, updateEnd);
+    }
+
+    // leave DIV and TIMA current for anything reading memory directly between updates
+    timer->sync();
+
+#ifdef MEMORY_PROFILE
+    // the signal handler can't write files, the dump happens here on its behalf
+    if(memoryProfileRequestsSeen != memoryProfileRequests){
+        memoryProfileRequestsSeen = memoryProfileRequests;
+        dumpMemoryProfile();
     }
+#endif
+}
 
-    //printf("\n0xA000: %x\n", memory->readByte(0xA000));
+#ifndef HEADLESS
+// the window can close from anywhere, so the trace is written on the way out
+static Gameboy *tracedGameboy = nullptr;
+static std::string traceFilename = "";
+
+static void dumpTraceAtExit(){
+    tracedGameboy->dumpTrace(traceFilename);
+}
+
+static Gameboy *savingGameboy = nullptr;
+
+static void flushSaveAtExit(){
+    savingGameboy->flushBatterySave();
+}
+
+static Gameboy *profiledGameboy = nullptr;
+
+static void dumpMemoryProfileAtExit(){
+    profiledGameboy->dumpMemoryProfile();
+}
+
+static Gameboy *presentingGameboy = nullptr;
+
+static void printPresentTimeAtExit(){
+    if(presentingGameboy->framesPresented > 0){
+        printf("presented %d frames, %.1f us/frame\n", presentingGameboy->framesPresented, presentingGameboy->presentNanoseconds / 1000.0 / presentingGameboy->framesPresented);
+    }
 }
 
 int main(int argc, char **argv){
     if(argc < 2){
-        std::cout << "usage: ./gameboy filename" << std::endl;
+        std::cout << "usage: ./gameboy filename [traceFile]" << std::endl;
     }
 
     Gameboy *gameboy = new Gameboy(argv[1]);
+    presentingGameboy = gameboy;
+    std::atexit(printPresentTimeAtExit);
+
+    if(gameboy->enableBatterySave()){
+        savingGameboy = gameboy;
+        std::atexit(flushSaveAtExit);
+    }
 
     if(argc == 3){
         gameboy->toggleDebugMode(true);
+        tracedGameboy = gameboy;
+        traceFilename = argv[2];
+        std::atexit(dumpTraceAtExit);
+    }
+
+    // GAMEBOY_COLOURS is a scheme name or 4 rrggbb colours, lightest first
+    const char *colours = getenv("GAMEBOY_COLOURS");
+    if(colours && !gameboy->setColourScheme(colours)){
+        std::cout << "unknown colour scheme " << colours << ", staying grey" << std::endl;
+    }
+
+#ifdef MEMORY_PROFILE
+    // MEMORY_PROFILE_FILE picks where it goes, .json for JSON
+    const char *profileFilename = getenv("MEMORY_PROFILE_FILE");
+    if(gameboy->profileMemory(profileFilename ? profileFilename : "memory_profile.csv")){
+        profiledGameboy = gameboy;
+        std::atexit(dumpMemoryProfileAtExit);
     }
+#endif
     // should take 143 updates to pass the test
     int i = 0;
 
@@ -119,4 +565,5 @@ int main(int argc, char **argv){
         i++;
     }
     
-}   
\ No newline at end of file
+}
+#endif
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <iostream>
+#ifndef HEADLESS
 #include <SDL2/SDL.h>
+#endif
 #include <ctime>
 #include <chrono>
 #include <thread>
@@ -14,6 +16,9 @@
 #include "timer.hh"
 #include "ppu.hh"
 #include "joypad.hh"
+#include "blockcache.hh"
+#include "jit.hh"
+#include "scheduler.hh"
 
 #define VBLANK 0
 #define LCD 1
@@ -23,6 +28,9 @@
 
 #define CLOCK_SPEED 4194304
 #define MAX_CYCLE 69905
+
+// the joypad is polled whenever the cycles this update land on a multiple of this
+#define KEY_POLL_CYCLES 5000
 #define FRAME_TIME 
 
 class Gameboy{
@@ -30,10 +38,49 @@ class Gameboy{
         std::chrono::time_point<std::chrono::system_clock> lastFrameTime = std::chrono::system_clock::now();
         int frame = 0;
 
+        // skip a halted cpu straight to the next event instead of stepping 4 cycles at a time
+        bool haltFastForward = true;
+        uint64_t haltCyclesSkipped = 0;
+
+        // skip the iterations of loops polling LY, STAT or IF that can't see anything change
+        bool idleLoopSkip = true;
+        uint64_t idleCyclesSkipped = 0;
+
+        // time spent uploading and presenting finished frames, not counting the frame cap
+        uint64_t presentNanoseconds = 0;
+        int framesPresented = 0;
+
         Gameboy(std::string filename);
         void renderScreen();
         void update();
         void toggleDebugMode(bool val);
+        void toggleBlockCache(bool val);
+        void toggleHaltFastForward(bool val);
+        void toggleIdleLoopSkip(bool val);
+        void runEvents();
+        uint16_t runCPU(uint64_t updateEnd);
+        void checkIdleLoop(uint16_t pcBefore, uint64_t updateEnd);
+        int cyclesToNextEvent(uint64_t updateEnd);
+        int haltCycles(uint64_t updateEnd);
+        int skipIdleLoop(uint16_t branchAddress, uint64_t updateEnd);
+        bool toggleJIT(bool val);
+        uint64_t getJITRunsCompiled();
+        const char *getMBCName();
+        bool enableBatterySave(int syncIntervalMs = SAVE_SYNC_INTERVAL_MS);
+        void flushBatterySave();
+        void dumpTrace(std::string filename);
+        double benchmarkScanlines(int kernel, int frames);
+        uint64_t sweepOpcode(uint16_t opcode, int samples);
+        bool setColourScheme(std::string scheme);
+        bool setLCDFormat(std::string format);
+        uint64_t frameHash();
+        void watchVideo(VideoDirty *dirty);
+        void unwatchVideo(VideoDirty *dirty);
+        const char *getLCDFormatName();
+        size_t getFrameSize();
+        bool profileMemory(std::string filename);
+        bool dumpMemoryProfile();
+        uint64_t getInstructionCount();
     private:
         CPU *cpu;
         Cartridge *cartridge;
@@ -42,9 +89,22 @@ class Gameboy{
         Timer *timer;
         PPU *ppu;
         Joypad *joypad;
+        BlockCache *blockCache;
+        JIT *jit = nullptr;
+        Scheduler *scheduler;
+
+        // where the memory profile goes at exit or on SIGUSR1, empty if nobody asked for it
+        std::string memoryProfileFilename = "";
+        int memoryProfileRequestsSeen = 0;
+
+        // the poll only happens if an instruction ends exactly on it
+        uint64_t nextKeyPoll = 0;
+        bool keyPollDue = false;
 
+#ifndef HEADLESS
         SDL_Window *window;
         SDL_Renderer *renderer;
         SDL_Texture *texture;
+#endif
 
 };
\ No newline at end of file
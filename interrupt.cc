@@ -8,10 +8,13 @@ Interrupt::Interrupt(Memory *memory){
 
 void Interrupt::toggleIME(bool enable){
     IME = enable;
+    if(enable){
+        memory->interruptCheckDue = true;
+    }
 }
 
 void Interrupt::requestInterrupt(uint8_t interruptCode){
-    uint8_t interruptFlag = memory->readByte(INTERRUPT_FLAG);
-    interruptFlag |= (1 << interruptCode);
-    memory->writeByte(INTERRUPT_FLAG, interruptFlag);
+    // the hardware setting a flag, not the game writing IF
+    memory->memory[INTERRUPT_FLAG] |= (1 << interruptCode);
+    memory->interruptCheckDue = true;
 }
\ No newline at end of file
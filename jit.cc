@@ -0,0 +1,439 @@
+#include <cstring>
+
+#include "jit.hh"
+#include "cpu.hh"
+
+#ifdef JIT_SUPPORTED
+#include <sys/mman.h>
+#ifdef __APPLE__
+#include <pthread.h>
+#endif
+#endif
+
+// generous upper bound on the bytes emitted for one instruction
+#define MAX_EMITTED_BYTES 128
+
+// index of A in registerOffset, the same order the opcodes encode registers in
+#define REGISTER_A 7
+#define REGISTER_HL_INDIRECT 6
+
+JIT::JIT(CPU *cpu){
+    // the native code addresses registers relative to the CPU it is called with
+    uint8_t *base = (uint8_t *) cpu;
+    registerOffset[0] = &cpu->RegBC.hi - base;
+    registerOffset[1] = &cpu->RegBC.lo - base;
+    registerOffset[2] = &cpu->RegDE.hi - base;
+    registerOffset[3] = &cpu->RegDE.lo - base;
+    registerOffset[4] = &cpu->RegHL.hi - base;
+    registerOffset[5] = &cpu->RegHL.lo - base;
+    registerOffset[6] = 0;
+    registerOffset[7] = &cpu->RegAF.hi - base;
+    offsetF = &cpu->RegAF.lo - base;
+    offsetBC = (uint8_t *) &cpu->RegBC.reg - base;
+    offsetDE = (uint8_t *) &cpu->RegDE.reg - base;
+    offsetHL = (uint8_t *) &cpu->RegHL.reg - base;
+    offsetSP = (uint8_t *) &cpu->StackPointer.reg - base;
+
+#ifdef JIT_SUPPORTED
+#ifdef __APPLE__
+    // the hardened runtime only hands out executable memory mapped for a jit
+    void *mapping = mmap(nullptr, JIT_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | MAP_JIT, -1, 0);
+#else
+    // never writable and executable at once, see setWritable
+    void *mapping = mmap(nullptr, JIT_CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#endif
+    if(mapping == MAP_FAILED){
+        std::cout << "could not map memory for the jit, staying on the interpreter" << std::endl;
+        return;
+    }
+    code = (uint8_t *) mapping;
+
+    // hosts that forbid executable anonymous memory say so here rather than on the first compile
+    if(!setWritable(false)){
+        std::cout << "could not make the jit's memory executable, staying on the interpreter" << std::endl;
+        munmap(code, JIT_CODE_SIZE);
+        code = nullptr;
+    }
+#endif
+}
+
+JIT::~JIT(){
+#ifdef JIT_SUPPORTED
+    if(code){
+        munmap(code, JIT_CODE_SIZE);
+    }
+#endif
+}
+
+/**
+ * @brief
+ * Flip the code buffer between writable and executable, it is never both.
+ * Apple's MAP_JIT memory is switched per thread with
+ * pthread_jit_write_protect_np instead of mprotect.
+ */
+bool JIT::setWritable(bool writable){
+#ifdef JIT_SUPPORTED
+#ifdef __APPLE__
+    if(__builtin_available(macOS 11.0, *)){
+        if(pthread_jit_write_protect_supported_np()){
+            pthread_jit_write_protect_np(!writable);
+        }
+    }
+    return true;
+#else
+    return mprotect(code, JIT_CODE_SIZE, writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) == 0;
+#endif
+#else
+    (void) writable;
+    return false;
+#endif
+}
+
+// the host took the code buffer's permissions away, everything compiled is dropped and blocks run interpreted
+void JIT::disable(){
+    std::cout << "could not change the jit's memory protection, staying on the interpreter" << std::endl;
+#ifdef JIT_SUPPORTED
+    munmap(code, JIT_CODE_SIZE);
+#endif
+    code = nullptr;
+    generation++;
+}
+
+bool JIT::available(){
+    return code != nullptr;
+}
+
+bool JIT::canCompile(uint8_t opCode){
+    uint8_t dst = (opCode >> 3) & 7;
+    uint8_t src = opCode & 7;
+
+    if(opCode >= 0x40 && opCode < 0x80){
+        // LD r, r but not through (HL), 0x76 is HALT
+        return dst != REGISTER_HL_INDIRECT && src != REGISTER_HL_INDIRECT;
+    }
+    if(opCode >= 0x80 && opCode < 0xC0){
+        // alu ops on A
+        return src != REGISTER_HL_INDIRECT;
+    }
+    if(opCode < 0x40){
+        switch(opCode & 0x07){
+            case 0x04: // INC r
+            case 0x05: // DEC r
+            case 0x06: // LD r, u8
+                return dst != REGISTER_HL_INDIRECT;
+            default:
+                break;
+        }
+        switch(opCode & 0x0F){
+            case 0x01: // LD rr, u16
+            case 0x03: // INC rr
+            case 0x0B: // DEC rr
+                return true;
+            default:
+                break;
+        }
+        // NOP, CPL, SCF, CCF
+        return opCode == 0x00 || opCode == 0x2F || opCode == 0x37 || opCode == 0x3F;
+    }
+    // alu ops on A with an immediate, LD SP, HL
+    return (opCode & 0xC7) == 0xC6 || opCode == 0xF9;
+}
+
+void JIT::compile(CodeBlock &block){
+    size_t count = block.instructions.size();
+    block.nativeRuns.clear();
+    block.nativeRunAt.assign(count, -1);
+
+    if(!available()){
+        // don't try again every time the block is entered
+        block.nativeGeneration = generation;
+        return;
+    }
+
+    if(!setWritable(true)){
+        disable();
+        block.nativeGeneration = generation;
+        return;
+    }
+
+    // every run of the block has to land in the same generation
+    if(codeUsed + count * MAX_EMITTED_BYTES > JIT_CODE_SIZE){
+        codeUsed = 0;
+        generation++;
+        flushes++;
+    }
+
+    size_t i = 0;
+    while(i < count){
+        if(!canCompile(block.instructions[i].opCode)){
+            i++;
+            continue;
+        }
+
+        size_t first = i;
+        NativeRun run = {nullptr, 0, 0, 0};
+        emitted.clear();
+
+        while(i < count && canCompile(block.instructions[i].opCode)){
+            const DecodedInstruction &instruction = block.instructions[i];
+            uint8_t cycles = opcodeTable[instruction.opCode].cycles;
+            if(run.cycles + cycles > MAX_NATIVE_CYCLES){
+                break;
+            }
+
+            emitInstruction(instruction);
+            run.instructionCount++;
+            run.length += instruction.length;
+            run.cycles += cycles;
+            i++;
+        }
+
+        // a single instruction is no faster native than through the interpreter
+        if(run.instructionCount < 2){
+            continue;
+        }
+
+        // ret
+        emitByte(0xC3);
+        run.code = install();
+
+        block.nativeRunAt[first] = block.nativeRuns.size();
+        block.nativeRuns.push_back(run);
+        runsCompiled++;
+    }
+
+    if(!setWritable(false)){
+        block.nativeRuns.clear();
+        block.nativeRunAt.assign(count, -1);
+        disable();
+    }
+    block.nativeGeneration = generation;
+}
+
+NativeCode JIT::install(){
+    uint8_t *start = code + codeUsed;
+    memcpy(start, emitted.data(), emitted.size());
+    codeUsed += emitted.size();
+    return (NativeCode) start;
+}
+
+/**
+ * @brief
+ * Native code is called as void(CPU *), so rdi holds the cpu and every
+ * register access is [rdi + disp32]. rax, rcx and rdx are scratch.
+ */
+void JIT::emitInstruction(const DecodedInstruction &instruction){
+    uint8_t opCode = instruction.opCode;
+    uint8_t dst = (opCode >> 3) & 7;
+    uint8_t src = opCode & 7;
+    int32_t pairOffsets[4] = {offsetBC, offsetDE, offsetHL, offsetSP};
+
+    if(opCode == 0x00){
+        // NOP
+        return;
+    }
+
+    if(opCode >= 0x40 && opCode < 0x80){
+        // LD r, r: mov al, [src]; mov [dst], al
+        emitWithDisplacement({0x8A, 0x87}, registerOffset[src]);
+        emitWithDisplacement({0x88, 0x87}, registerOffset[dst]);
+        return;
+    }
+
+    if(opCode >= 0x80 && opCode < 0xC0){
+        emitAlu(dst, instruction);
+        return;
+    }
+
+    if((opCode & 0xC7) == 0xC6){
+        emitAlu(dst, instruction);
+        return;
+    }
+
+    switch(opCode){
+        case 0x2F:
+            // CPL: not byte [A]; or byte [F], 0x60
+            emitWithDisplacement({0xF6, 0x97}, registerOffset[REGISTER_A]);
+            emitWithDisplacement({0x80, 0x8F}, offsetF);
+            emitByte(0x60);
+            return;
+        case 0x37:
+            // SCF: and byte [F], 0x8F; or byte [F], 0x10
+            emitWithDisplacement({0x80, 0xA7}, offsetF);
+            emitByte(0x8F);
+            emitWithDisplacement({0x80, 0x8F}, offsetF);
+            emitByte(0x10);
+            return;
+        case 0x3F:
+            // CCF: xor byte [F], 0x10; and byte [F], 0x9F
+            emitWithDisplacement({0x80, 0xB7}, offsetF);
+            emitByte(0x10);
+            emitWithDisplacement({0x80, 0xA7}, offsetF);
+            emitByte(0x9F);
+            return;
+        case 0xF9:
+            // LD SP, HL: mov ax, [HL]; mov [SP], ax
+            emitWithDisplacement({0x66, 0x8B, 0x87}, offsetHL);
+            emitWithDisplacement({0x66, 0x89, 0x87}, offsetSP);
+            return;
+        default:
+            break;
+    }
+
+    switch(opCode & 0x07){
+        case 0x04:
+            // INC r: inc byte [r], carry is left alone
+            emitWithDisplacement({0xFE, 0x87}, registerOffset[dst]);
+            emitFlags(true, true, false, 0x00, 0x1F);
+            return;
+        case 0x05:
+            // DEC r: dec byte [r], carry is left alone
+            emitWithDisplacement({0xFE, 0x8F}, registerOffset[dst]);
+            emitFlags(true, true, false, 0x40, 0x1F);
+            return;
+        case 0x06:
+            // LD r, u8: mov byte [r], imm8
+            emitWithDisplacement({0xC6, 0x87}, registerOffset[dst]);
+            emitByte(instruction.operands[0]);
+            return;
+        default:
+            break;
+    }
+
+    switch(opCode & 0x0F){
+        case 0x01:
+            // LD rr, u16: mov word [rr], imm16
+            emitWithDisplacement({0x66, 0xC7, 0x87}, pairOffsets[opCode >> 4]);
+            emitByte(instruction.operands[0]);
+            emitByte(instruction.operands[1]);
+            return;
+        case 0x03:
+            // INC rr: inc word [rr]
+            emitWithDisplacement({0x66, 0xFF, 0x87}, pairOffsets[opCode >> 4]);
+            return;
+        case 0x0B:
+            // DEC rr: dec word [rr]
+            emitWithDisplacement({0x66, 0xFF, 0x8F}, pairOffsets[opCode >> 4]);
+            return;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief
+ * ADD ADC SUB SBC AND XOR OR CP on A. x86 computes the same zero, half carry
+ * (AF) and carry bits the gameboy does, so they are copied straight out of
+ * the host flags.
+ */
+void JIT::emitAlu(uint8_t operation, const DecodedInstruction &instruction){
+    // op al, [rdi + disp32] and op al, imm8 in gameboy operation order
+    const uint8_t registerForm[8] = {0x02, 0x12, 0x2A, 0x1A, 0x22, 0x32, 0x0A, 0x3A};
+    const uint8_t immediateForm[8] = {0x04, 0x14, 0x2C, 0x1C, 0x24, 0x34, 0x0C, 0x3C};
+    bool immediate = instruction.opCode >= 0xC0;
+
+    // mov al, [A]
+    emitWithDisplacement({0x8A, 0x87}, registerOffset[REGISTER_A]);
+
+    if(operation == 1 || operation == 3){
+        // ADC and SBC take the carry in: movzx ecx, byte [F]; bt ecx, 4
+        emitWithDisplacement({0x0F, 0xB6, 0x8F}, offsetF);
+        emitByte(0x0F);
+        emitByte(0xBA);
+        emitByte(0xE1);
+        emitByte(FLAG_C);
+    }
+
+    if(immediate){
+        emitByte(immediateForm[operation]);
+        emitByte(instruction.operands[0]);
+    }
+    else{
+        emitWithDisplacement({registerForm[operation], 0x87}, registerOffset[instruction.opCode & 7]);
+    }
+
+    // mov [A], al, mov leaves the flags alone. CP only compares
+    if(operation != 7){
+        emitWithDisplacement({0x88, 0x87}, registerOffset[REGISTER_A]);
+    }
+
+    switch(operation){
+        case 0: case 1:
+            emitFlags(true, true, true, 0x00, 0x0F);
+            break;
+        case 2: case 3: case 7:
+            emitFlags(true, true, true, 0x40, 0x0F);
+            break;
+        case 4:
+            emitFlags(true, false, false, 0x20, 0x0F);
+            break;
+        default:
+            emitFlags(true, false, false, 0x00, 0x0F);
+            break;
+    }
+}
+
+/**
+ * @brief
+ * Build F out of the host flags left by the last instruction.
+ * F = host Z/H/C where asked | setBits | (old F & keepBits)
+ */
+void JIT::emitFlags(bool hostZero, bool hostHalfCarry, bool hostCarry, uint8_t setBits, uint8_t keepBits){
+    // pushfq; pop rcx
+    emitByte(0x9C);
+    emitByte(0x59);
+    // xor edx, edx
+    emitByte(0x31);
+    emitByte(0xD2);
+
+    // host bit, shift to move it to its place in F
+    struct{ bool wanted; uint8_t mask; uint8_t shiftLeft; } bits[3] = {
+        {hostZero, 0x40, 1},
+        {hostHalfCarry, 0x10, 1},
+        {hostCarry, 0x01, 4},
+    };
+    for(int i = 0; i < 3; i++){
+        if(!bits[i].wanted){
+            continue;
+        }
+        // mov eax, ecx; and eax, mask; shl eax, shift; or edx, eax
+        emitByte(0x89); emitByte(0xC8);
+        emitByte(0x83); emitByte(0xE0); emitByte(bits[i].mask);
+        emitByte(0xC1); emitByte(0xE0); emitByte(bits[i].shiftLeft);
+        emitByte(0x09); emitByte(0xC2);
+    }
+
+    if(setBits){
+        // or edx, setBits
+        emitByte(0x83);
+        emitByte(0xCA);
+        emitByte(setBits);
+    }
+
+    if(keepBits){
+        // movzx eax, byte [F]; and eax, keepBits; or edx, eax
+        emitWithDisplacement({0x0F, 0xB6, 0x87}, offsetF);
+        emitByte(0x83); emitByte(0xE0); emitByte(keepBits);
+        emitByte(0x09); emitByte(0xC2);
+    }
+
+    // mov [F], dl
+    emitWithDisplacement({0x88, 0x97}, offsetF);
+}
+
+void JIT::emitByte(uint8_t byte){
+    emitted.push_back(byte);
+}
+
+void JIT::emitDisplacement(int32_t displacement){
+    for(int i = 0; i < 4; i++){
+        emitByte((displacement >> (i * 8)) & 0xFF);
+    }
+}
+
+void JIT::emitWithDisplacement(std::initializer_list<uint8_t> prefix, int32_t displacement){
+    for(uint8_t byte : prefix){
+        emitByte(byte);
+    }
+    emitDisplacement(displacement);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include "blockcache.hh"
+
+// the emitter only knows x86-64 and the System V calling convention
+#if defined(__x86_64__) && !defined(_WIN32)
+#define JIT_SUPPORTED
+#endif
+
+// bytes of executable memory handed out to compiled runs before everything is thrown away
+#define JIT_CODE_SIZE 0x400000
+
+// times a block has to be entered before it is worth compiling
+#define JIT_HOT_THRESHOLD 16
+
+// the timer and ppu only see the cycles of a run once it is done, so keep runs short
+#define MAX_NATIVE_CYCLES 64
+
+class CPU;
+
+/**
+ * @brief
+ * Translates the register only instructions of hot blocks (loads between
+ * registers, immediates, 8 bit alu ops on A, INC/DEC) into x86-64. Anything
+ * that touches memory, the stack or control flow is left to CPU::executeOP,
+ * so a compiled run always falls through to the next instruction and the cpu
+ * only has to account for its cycles and check interrupts after it.
+ */
+class JIT{
+    public:
+        // bumped when the code buffer is recycled, runs compiled in an older generation are dead
+        uint32_t generation = 1;
+        uint64_t runsCompiled = 0;
+        uint64_t flushes = 0;
+
+        JIT(CPU *cpu);
+        ~JIT();
+
+        bool available();
+        void compile(CodeBlock &block);
+
+        static bool canCompile(uint8_t opCode);
+
+    private:
+        uint8_t *code = nullptr;
+        size_t codeUsed = 0;
+
+        // offsets of the gameboy registers from the CPU pointer the native code is called with
+        int32_t registerOffset[8];
+        int32_t offsetF;
+        int32_t offsetBC;
+        int32_t offsetDE;
+        int32_t offsetHL;
+        int32_t offsetSP;
+
+        std::vector<uint8_t> emitted;
+
+        NativeCode install();
+        bool setWritable(bool writable);
+        void disable();
+
+        void emitInstruction(const DecodedInstruction &instruction);
+        void emitByte(uint8_t byte);
+        void emitDisplacement(int32_t displacement);
+        void emitWithDisplacement(std::initializer_list<uint8_t> prefix, int32_t displacement);
+        void emitAlu(uint8_t operation, const DecodedInstruction &instruction);
+        void emitFlags(bool hostZero, bool hostHalfCarry, bool hostCarry, uint8_t setBits, uint8_t keepBits);
+};
@@ -1,10 +1,14 @@
 #include "joypad.hh"
 
+#ifndef HEADLESS
 Joypad::Joypad(SDL_Window *window, SDL_Texture *texture, SDL_Renderer *renderer){
     this->window = window;
     this->texture = texture;
     this->renderer = renderer;
 }
+#else
+Joypad::Joypad(){}
+#endif
 
 uint8_t Joypad::getJoypad(uint8_t currState){
     currState |= 0xF;
@@ -44,6 +48,10 @@ uint8_t Joypad::getJoypad(uint8_t currState){
 }
 
 void Joypad::keyPoll(){
+#ifdef HEADLESS
+    // no input source when running headless, every button stays released
+    return;
+#else
     SDL_Event e;
 
     SDL_PollEvent(&e);
@@ -115,4 +123,5 @@ void Joypad::keyPoll(){
             }
             break;
     }
+#endif
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <iostream>
+#ifndef HEADLESS
 #include <SDL2/SDL.h>
+#endif
 
 #define JOYPAD_REGISTER 0xFF00
 
@@ -26,7 +28,11 @@ class Joypad{
          * backspace = select
          * arrow pad = directional controls
          */
+#ifndef HEADLESS
         Joypad(SDL_Window *window, SDL_Texture *texture, SDL_Renderer *renderer);
+#else
+        Joypad();
+#endif
 
         uint8_t getJoypad(uint8_t currState);
         void keyPoll();
@@ -42,7 +48,9 @@ class Joypad{
         bool rightButton = false;
         bool downButton = false;
 
+#ifndef HEADLESS
         SDL_Window *window; 
         SDL_Texture *texture; 
         SDL_Renderer *renderer;
+#endif
 };
\ No newline at end of file
@@ -1,41 +1,210 @@
 #pragma once
 
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
-#define MAX_GAME_SIZE 0x200000
+// 512 banks of 16KB, the most an MBC5 can address
+#define MAX_GAME_SIZE 0x800000
 
+#define RAM_BANK_SIZE 0x2000
+
+// the rtc counts seconds of emulated time by default, same rate as CLOCK_SPEED
+#define RTC_CYCLES_PER_SECOND 4194304
+
+// rtc registers as selected by writing 0x08-0x0C to 0x4000-0x5FFF
+#define RTC_SECONDS 0
+#define RTC_MINUTES 1
+#define RTC_HOURS 2
+#define RTC_DAY_LOW 3
+#define RTC_DAY_HIGH 4
+#define RTC_REGISTER_COUNT 5
+
+// the rtc is saved after the external ram in the layout other emulators use:
+// the live and latched registers as 32 bit values, then a 64 bit unix timestamp
+#define RTC_SAVE_SIZE 48
+
+// state every bank controller has. The controllers aren't virtual, the
+// cartridge holds the one it needs in a variant so calls into it can be inlined
 class MBC{
     public:
-        uint8_t *rom;
+        const uint8_t *rom;
         uint8_t *ram;
         bool hasBattery;
-        uint8_t currRomBank = 1;
+        uint16_t currRomBank = 1;
         uint8_t currRamBank = 0;
-        uint8_t numRomBanks;
+        uint16_t numRomBanks;
         uint8_t numRamBanks;
-        virtual uint8_t readMemory(uint16_t){return 0;};
-        virtual void writeMemory(uint16_t, uint8_t){};
+
+        // battery backed state is the external ram, controllers with more to save hide these
+        size_t saveSize(){
+            return numRamBanks * RAM_BANK_SIZE;
+        }
+
+        // ram mapped onto a save file is already where it needs to be
+        void save(uint8_t *out){
+            if(ram && ram != out){
+                memcpy(out, ram, saveSize());
+            }
+        }
+
+        void load(const uint8_t *in, size_t size){
+            if(ram && ram != in){
+                memcpy(ram, in, std::min(size, saveSize()));
+            }
+        }
+
+        // swap the ram the controller allocated for memory it doesn't own, ie; a mapped save file
+        void useRAM(uint8_t *external){
+            if(numRamBanks == 0){
+                return;
+            }
+            delete[] ram;
+            ram = external;
+        }
 };
 
 class MBC0 : public MBC {
     public:
-        MBC0(uint8_t *rom){
+        static constexpr const char *name = "MBC0";
+
+        MBC0(const uint8_t *rom){
             this->rom = rom;
+            this->ram = nullptr;
+            this->numRamBanks = 0;
         };
-        uint8_t readMemory(uint16_t address) override {
+        uint8_t readMemory(uint16_t address){
             return rom[address];
         };
+        // no registers to write to
+        void writeMemory(uint16_t, uint8_t){};
 };
 
 class MBC1 : public MBC {
     public:
+        static constexpr const char *name = "MBC1";
+
         uint16_t lowBankNumber = 0;
         uint16_t highBankNumber = 0;
         bool enableRAM = false;
-        MBC1(uint8_t *rom, bool hasBattery, int numRamBanks, int numRomBanks);
+        MBC1(const uint8_t *rom, bool hasBattery, int numRamBanks, int numRomBanks);
         // 0 = simple, 1 = advanced
         bool bankMode = false;
-        uint8_t readMemory(uint16_t address) override;
-        void writeMemory(uint16_t address, uint8_t data) override;
+        void writeMemory(uint16_t address, uint8_t data);
+
+        uint8_t readMemory(uint16_t address){
+            if (address < 0x4000){
+                return this->rom[address];
+            }
+            else if (address < 0x8000){
+                uint32_t newAddress = (0x4000 * this->currRomBank) + (address - 0x4000);
+                return this->rom[newAddress];
+            }
+            else if(address >= 0xA000 && address < 0xC000){
+                if (this->enableRAM && this->numRamBanks > 0){
+                    if (this->numRamBanks < 4){
+                        uint16_t newAddress = (address - 0xA000) % (numRamBanks * 0x2000);
+                        return this->ram[newAddress];
+                    }
+                    else{
+                        if (this->bankMode){
+                            uint16_t newAddress = 0x2000 * this->currRamBank + (address - 0xA000);
+                            return this->ram[newAddress];
+                        }
+                        else{
+                            uint16_t newAddress = address - 0xA000;
+                            return this->ram[newAddress];
+                        }
+                    }
+                }
+            }
+            return 0xFF;
+        }
+
         void adjustRomBankNum();
-};
\ No newline at end of file
+};
+
+class MBC3 : public MBC {
+    public:
+        static constexpr const char *name = "MBC3";
+
+        bool enableRAM = false;
+        bool hasTimer;
+        // count host seconds instead of emulated ones, never in a headless build
+        bool useHostTime = false;
+
+        // 0-3 selects a ram bank, 0x08-0x0C an rtc register
+        uint8_t bankSelect = 0;
+
+        MBC3(const uint8_t *rom, bool hasBattery, bool hasTimer, int numRamBanks, int numRomBanks);
+        void setClock(const uint64_t *clock);
+        void writeMemory(uint16_t address, uint8_t data);
+
+        uint8_t readMemory(uint16_t address){
+            if(address < 0xA000 || address >= 0xC000 || !enableRAM){
+                return 0xFF;
+            }
+
+            if(bankSelect >= 0x08 && bankSelect <= 0x0C){
+                return hasTimer ? latched[bankSelect - 0x08] : 0xFF;
+            }
+
+            if(bankSelect >= numRamBanks){
+                return 0xFF;
+            }
+            return ram[bankSelect * RAM_BANK_SIZE + (address - 0xA000)];
+        }
+
+        // 0xA000-0xBFFF reaches an rtc register rather than ram
+        bool rtcSelected(){
+            return hasTimer && bankSelect >= 0x08 && bankSelect <= 0x0C;
+        }
+
+        size_t saveSize();
+        void save(uint8_t *out);
+        void saveRTC(uint8_t *footer);
+        void load(const uint8_t *in, size_t size);
+
+    private:
+        // the emulated cycle counter the rtc reads its time from
+        const uint64_t *clock = nullptr;
+
+        // the clock as of rtcSyncedAt, it's only brought forward when the game looks at it
+        int seconds = 0;
+        int minutes = 0;
+        int hours = 0;
+        int days = 0;
+        bool halted = false;
+        bool dayCarry = false;
+        uint64_t rtcSyncedAt = 0;
+
+        uint8_t latched[RTC_REGISTER_COUNT] = {0};
+        uint8_t lastLatchWrite = 0xFF;
+
+        uint64_t rtcNow();
+        uint64_t rtcUnitsPerSecond();
+        void syncRTC();
+        void advanceRTC(uint64_t elapsedSeconds);
+        uint8_t readRTC(int reg);
+        void writeRTC(int reg, uint8_t data);
+};
+
+class MBC5 : public MBC {
+    public:
+        static constexpr const char *name = "MBC5";
+
+        bool enableRAM = false;
+        // bit 3 of the ram bank register drives the motor on these, not the ram bank
+        bool hasRumble;
+        bool rumbling = false;
+
+        MBC5(const uint8_t *rom, bool hasBattery, bool hasRumble, int numRamBanks, int numRomBanks);
+        void writeMemory(uint16_t address, uint8_t data);
+
+        uint8_t readMemory(uint16_t address){
+            if(address < 0xA000 || address >= 0xC000 || !enableRAM || currRamBank >= numRamBanks){
+                return 0xFF;
+            }
+            return ram[currRamBank * RAM_BANK_SIZE + (address - 0xA000)];
+        }
+};
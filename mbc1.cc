@@ -1,45 +1,17 @@
 #include "mbc.hh"
 
-MBC1::MBC1(uint8_t *rom, bool hasBattery, int numRamBanks, int numRomBanks){
+MBC1::MBC1(const uint8_t *rom, bool hasBattery, int numRamBanks, int numRomBanks){
     this->rom = rom;
     this->hasBattery = hasBattery;
     this->numRamBanks = numRamBanks;
     this->numRomBanks = numRomBanks;
+    this->ram = nullptr;
     // instantiate external RAM
     if(numRamBanks > 0){
-        this->ram = new uint8_t[numRamBanks * 0x2000];
+        this->ram = new uint8_t[numRamBanks * RAM_BANK_SIZE]();
     }
 }
 
-uint8_t MBC1::readMemory(uint16_t address){
-    if (address < 0x4000){
-        return this->rom[address];
-    }
-    else if (address < 0x8000){
-        uint32_t newAddress = (0x4000 * this->currRomBank) + (address - 0x4000);
-        return this->rom[newAddress];
-    }
-    else if(address >= 0xA000 && address < 0xC000){
-        if (this->enableRAM){
-            if (this->numRamBanks < 4){
-                uint16_t newAddress = (address - 0xA000) % (numRamBanks * 0x2000);
-                return this->ram[newAddress];
-            }
-            else{
-                if (this->bankMode){
-                    uint16_t newAddress = 0x2000 * this->currRamBank + (address - 0xA000);
-                    return this->ram[newAddress];
-                }
-                else{
-                    uint16_t newAddress = address - 0xA000;
-                    return this->ram[newAddress];
-                }
-            }
-        }
-    }
-    return 0xFF;
-}
-
 void MBC1::writeMemory(uint16_t address, uint8_t data){
     if (address < 0x2000){
         enableRAM = (data & 0xF) == 0xA;
@@ -74,7 +46,7 @@ void MBC1::writeMemory(uint16_t address, uint8_t data){
     }
     else if(address >= 0xA000 && address < 0xC000){
         // external RAM write
-        if (enableRAM){
+        if (enableRAM && this->numRamBanks > 0){
             if(this->numRamBanks < 4){
                 uint16_t newAddress = (address - 0xA000) % (this->numRamBanks * 0x2000);
                 this->ram[newAddress] = data;
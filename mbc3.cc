@@ -0,0 +1,230 @@
+#include <ctime>
+
+#include "mbc.hh"
+
+MBC3::MBC3(const uint8_t *rom, bool hasBattery, bool hasTimer, int numRamBanks, int numRomBanks){
+    this->rom = rom;
+    this->hasBattery = hasBattery;
+    this->hasTimer = hasTimer;
+    this->numRamBanks = numRamBanks;
+    this->numRomBanks = numRomBanks;
+    this->ram = nullptr;
+    // instantiate external RAM
+    if(numRamBanks > 0){
+        this->ram = new uint8_t[numRamBanks * RAM_BANK_SIZE]();
+    }
+
+#ifndef HEADLESS
+    // someone is playing, the clock should keep real time
+    this->useHostTime = true;
+#endif
+    rtcSyncedAt = rtcNow();
+}
+
+void MBC3::setClock(const uint64_t *clock){
+    this->clock = clock;
+    rtcSyncedAt = rtcNow();
+}
+
+void MBC3::writeMemory(uint16_t address, uint8_t data){
+    if(address < 0x2000){
+        // enables the rtc registers as well
+        enableRAM = (data & 0xF) == 0xA;
+    }
+    else if(address < 0x4000){
+        // all 7 bits of the rom bank in one register, bank 0 maps to 1
+        currRomBank = data & 0x7F;
+        if(currRomBank == 0){
+            currRomBank = 1;
+        }
+    }
+    else if(address < 0x6000){
+        bankSelect = data & 0x0F;
+        if(bankSelect < 0x08){
+            currRamBank = bankSelect;
+        }
+    }
+    else if(address < 0x8000){
+        // writing 0 then 1 copies the clock into the registers the game reads
+        if(hasTimer && lastLatchWrite == 0x00 && data == 0x01){
+            syncRTC();
+            for(int reg = 0; reg < RTC_REGISTER_COUNT; reg++){
+                latched[reg] = readRTC(reg);
+            }
+        }
+        lastLatchWrite = data;
+    }
+    else if(address >= 0xA000 && address < 0xC000 && enableRAM){
+        if(bankSelect >= 0x08 && bankSelect <= 0x0C){
+            if(hasTimer){
+                writeRTC(bankSelect - 0x08, data);
+            }
+        }
+        else if(bankSelect < numRamBanks){
+            ram[bankSelect * RAM_BANK_SIZE + (address - 0xA000)] = data;
+        }
+    }
+}
+
+// what the rtc counts in, emulated cycles unless it's following the host's clock
+uint64_t MBC3::rtcNow(){
+    if(useHostTime){
+        return (uint64_t) time(nullptr);
+    }
+    return clock ? *clock : 0;
+}
+
+uint64_t MBC3::rtcUnitsPerSecond(){
+    return useHostTime ? 1 : RTC_CYCLES_PER_SECOND;
+}
+
+/**
+ * @brief
+ * Bring the clock forward by the whole seconds since it was last looked at,
+ * the part of a second that hasn't finished yet carries over to the next sync.
+ * Nothing ticks the rtc in between.
+ */
+void MBC3::syncRTC(){
+    uint64_t now = rtcNow();
+    if(now < rtcSyncedAt){
+        // the host clock went backwards, don't count it
+        rtcSyncedAt = now;
+        return;
+    }
+
+    uint64_t elapsed = (now - rtcSyncedAt) / rtcUnitsPerSecond();
+    rtcSyncedAt += elapsed * rtcUnitsPerSecond();
+    if(!halted && elapsed > 0){
+        advanceRTC(elapsed);
+    }
+}
+
+void MBC3::advanceRTC(uint64_t elapsedSeconds){
+    uint64_t total = seconds + elapsedSeconds;
+    seconds = total % 60;
+    total = minutes + total / 60;
+    minutes = total % 60;
+    total = hours + total / 60;
+    hours = total % 24;
+    total = days + total / 24;
+
+    // the day counter is 9 bits, the carry stays set until the game clears it
+    if(total > 0x1FF){
+        dayCarry = true;
+    }
+    days = total & 0x1FF;
+}
+
+uint8_t MBC3::readRTC(int reg){
+    switch(reg){
+        case RTC_SECONDS:
+            return seconds;
+        case RTC_MINUTES:
+            return minutes;
+        case RTC_HOURS:
+            return hours;
+        case RTC_DAY_LOW:
+            return days & 0xFF;
+        case RTC_DAY_HIGH:
+            return ((days >> 8) & 1) | (halted << 6) | (dayCarry << 7);
+    }
+    return 0xFF;
+}
+
+void MBC3::writeRTC(int reg, uint8_t data){
+    // the old value keeps everything counted up to now
+    syncRTC();
+
+    switch(reg){
+        case RTC_SECONDS:
+            // writing the seconds restarts the current second
+            seconds = data & 0x3F;
+            rtcSyncedAt = rtcNow();
+            break;
+        case RTC_MINUTES:
+            minutes = data & 0x3F;
+            break;
+        case RTC_HOURS:
+            hours = data & 0x1F;
+            break;
+        case RTC_DAY_LOW:
+            days = (days & 0x100) | data;
+            break;
+        case RTC_DAY_HIGH:
+            days = (days & 0xFF) | ((data & 1) << 8);
+            halted = data & (1 << 6);
+            dayCarry = data & (1 << 7);
+            break;
+    }
+}
+
+size_t MBC3::saveSize(){
+    return MBC::saveSize() + (hasTimer ? RTC_SAVE_SIZE : 0);
+}
+
+static void putLittleEndian(uint8_t *out, uint64_t value, int bytes){
+    for(int i = 0; i < bytes; i++){
+        out[i] = (value >> (i * 8)) & 0xFF;
+    }
+}
+
+static uint64_t getLittleEndian(const uint8_t *in, int bytes){
+    uint64_t value = 0;
+    for(int i = 0; i < bytes; i++){
+        value |= (uint64_t) in[i] << (i * 8);
+    }
+    return value;
+}
+
+void MBC3::save(uint8_t *out){
+    MBC::save(out);
+    if(hasTimer){
+        saveRTC(out + MBC::saveSize());
+    }
+}
+
+// just the rtc part of the save, what goes after the external ram
+void MBC3::saveRTC(uint8_t *footer){
+    syncRTC();
+    for(int reg = 0; reg < RTC_REGISTER_COUNT; reg++){
+        putLittleEndian(footer + reg * 4, readRTC(reg), 4);
+        putLittleEndian(footer + (RTC_REGISTER_COUNT + reg) * 4, latched[reg], 4);
+    }
+
+    // a headless run has no business knowing the wall clock, 0 means don't catch up on load
+    putLittleEndian(footer + RTC_REGISTER_COUNT * 8, useHostTime ? (uint64_t) time(nullptr) : 0, 8);
+}
+
+/**
+ * @brief
+ * Load the external ram and, if it's there, the rtc. Some emulators write a
+ * 32 bit timestamp, so the footer can be 4 bytes short. When following the
+ * host's clock, the time the save sat on disk is added on.
+ */
+void MBC3::load(const uint8_t *in, size_t size){
+    MBC::load(in, size);
+
+    size_t ramSize = MBC::saveSize();
+    if(!hasTimer || size < ramSize + RTC_SAVE_SIZE - 4){
+        return;
+    }
+
+    const uint8_t *footer = in + ramSize;
+    for(int reg = 0; reg < RTC_REGISTER_COUNT; reg++){
+        latched[reg] = getLittleEndian(footer + (RTC_REGISTER_COUNT + reg) * 4, 4);
+    }
+    seconds = getLittleEndian(footer + RTC_SECONDS * 4, 4) & 0x3F;
+    minutes = getLittleEndian(footer + RTC_MINUTES * 4, 4) & 0x3F;
+    hours = getLittleEndian(footer + RTC_HOURS * 4, 4) & 0x1F;
+    uint8_t dayHigh = getLittleEndian(footer + RTC_DAY_HIGH * 4, 4);
+    days = (getLittleEndian(footer + RTC_DAY_LOW * 4, 4) & 0xFF) | ((dayHigh & 1) << 8);
+    halted = dayHigh & (1 << 6);
+    dayCarry = dayHigh & (1 << 7);
+
+    rtcSyncedAt = rtcNow();
+    int timestampBytes = size >= ramSize + RTC_SAVE_SIZE ? 8 : 4;
+    uint64_t savedAt = getLittleEndian(footer + RTC_REGISTER_COUNT * 8, timestampBytes);
+    if(useHostTime && savedAt != 0 && rtcSyncedAt > savedAt && !halted){
+        advanceRTC(rtcSyncedAt - savedAt);
+    }
+}
@@ -0,0 +1,43 @@
+#include "mbc.hh"
+
+MBC5::MBC5(const uint8_t *rom, bool hasBattery, bool hasRumble, int numRamBanks, int numRomBanks){
+    this->rom = rom;
+    this->hasBattery = hasBattery;
+    this->hasRumble = hasRumble;
+    this->numRamBanks = numRamBanks;
+    this->numRomBanks = numRomBanks;
+    this->ram = nullptr;
+    // instantiate external RAM
+    if(numRamBanks > 0){
+        this->ram = new uint8_t[numRamBanks * RAM_BANK_SIZE]();
+    }
+}
+
+void MBC5::writeMemory(uint16_t address, uint8_t data){
+    if(address < 0x2000){
+        // only 0x0A enables the ram on an MBC5, not just the low nibble
+        enableRAM = data == 0x0A;
+    }
+    else if(address < 0x3000){
+        // low 8 bits of the rom bank, unlike the older mbcs bank 0 can be selected here
+        currRomBank = (currRomBank & 0x100) | data;
+    }
+    else if(address < 0x4000){
+        // 9th bit of the rom bank
+        currRomBank = (currRomBank & 0xFF) | ((data & 0x1) << 8);
+    }
+    else if(address < 0x6000){
+        if(hasRumble){
+            rumbling = data & 0x08;
+            currRamBank = data & 0x07;
+        }
+        else{
+            currRamBank = data & 0x0F;
+        }
+    }
+    else if(address >= 0xA000 && address < 0xC000){
+        if(enableRAM && currRamBank < numRamBanks){
+            ram[currRamBank * RAM_BANK_SIZE + (address - 0xA000)] = data;
+        }
+    }
+}
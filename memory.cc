@@ -1,12 +1,27 @@
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
 #include "memory.hh"
 
-Memory::Memory(Cartridge *cartridge, Joypad *joypad){
+Memory::Memory(Cartridge *cartridge, Joypad *joypad, Scheduler *scheduler){
     this->cartridge = cartridge;
     this->joypad = joypad;
+    this->scheduler = scheduler;
+
+    // rom reads come straight out of the cartridge, vram, wram, echo ram and oam out of memory
+    for(int page = 0; page < PAGE_COUNT; page++){
+        readPages[page] = nullptr;
+        writePages[page] = defaultWritePage(page);
+        if(page < 0x40){
+            readPages[page] = cartridge->rom + page * PAGE_SIZE;
+        }
+        else if(page >= 0x80 && page < 0xFF && (page < 0xA0 || page >= 0xC0)){
+            readPages[page] = memory + page * PAGE_SIZE;
+        }
+    }
+    mapRomBank();
 
-    loadCartridge();
     // timer registers
     memory[TIMA] = 0x0;
     memory[TMA] = 0x0;
@@ -15,39 +30,194 @@ Memory::Memory(Cartridge *cartridge, Joypad *joypad){
     memory[LY] = 0;
 
     memory[0xFF00] = 0xFF;
+
+    registerIO(JOYPAD_REGISTER, [this](uint16_t){
+        return this->joypad->getJoypad(memory[JOYPAD_REGISTER]);
+    }, nullptr);
+
+    registerIO(DMA, nullptr, [this](uint16_t, uint8_t content){
+        memory[DMA] = content;
+        startDMA(content);
+    });
+}
+
+// components hook their own registers in here
+void Memory::registerIO(uint16_t address, std::function<uint8_t(uint16_t)> read, std::function<void(uint16_t, uint8_t)> write, uint8_t writeMask){
+    IORegister &reg = io[address - IO_START];
+    reg.read = read;
+    reg.write = write;
+    reg.writeMask = writeMask;
 }
 
-void Memory::loadCartridge(){
-    printf("filesize: %d\n", cartridge->fileSize);
-    for(int i = 0; i < 0x4000; i++){
-        memory[i] = cartridge->rom[i];
+// the pages writes can go straight to when nothing needs to see them, vram and oam are tracked
+uint8_t *Memory::defaultWritePage(uint8_t page){
+    if(page >= 0xC0 && page < 0xFE){
+        return memory + page * PAGE_SIZE;
     }
-    for(int i = 0x4000; i < cartridge->fileSize; i++){
-        writeByte(i, cartridge->rom[i]);
+    return nullptr;
+}
+
+// point the switchable rom pages at the bank the mbc has selected
+void Memory::mapRomBank(){
+    const uint8_t *bank = cartridge->image->bank(cartridge->getRomBank());
+    const uint8_t **pages = dmaActive ? dmaReadPages : readPages;
+    for(int page = 0x40; page < 0x80; page++){
+        pages[page] = bank + (page - 0x40) * PAGE_SIZE;
     }
 }
 
-void Memory::writeByte(uint16_t address, uint8_t content){
+/**
+ * @brief
+ * Pages holding cached code are taken out of the write table so writes to
+ * them reach writeSlow and invalidate the code.
+ */
+void Memory::protectPage(uint8_t page, bool code){
+    (dmaActive ? dmaWritePages : writePages)[page] = code ? nullptr : defaultWritePage(page);
+}
+
+/**
+ * @brief
+ * Start an OAM DMA from source * 0x100. The source can't change while the
+ * transfer runs, the cpu is locked out of it, so all 160 bytes are copied up
+ * front. Everything below IO is then unmapped from the cpu until the transfer
+ * would have finished, DMA_CYCLES later. Writing DMA again restarts it.
+ */
+void Memory::startDMA(uint8_t source){
+    // there's no cartridge past WRAM, those sources read its echo instead
+    if(source >= 0xE0){
+        source -= 0x20;
+    }
+
+    const uint8_t *from = (dmaActive ? dmaReadPages : readPages)[source];
+    uint8_t cartridgeRAM[OAM_SIZE];
+    if(!from){
+        for(int i = 0; i < OAM_SIZE; i++){
+            cartridgeRAM[i] = cartridge->readCartridge((source << 8) | i);
+        }
+        from = cartridgeRAM;
+    }
+
+    // games DMA every frame whether their sprites moved or not, only the entries that changed are dirty
+    if(memcmp(memory + OAM_START, from, OAM_SIZE) != 0){
+        uint64_t changed = 0;
+        for(int entry = 0; entry < OAM_ENTRIES; entry++){
+            if(memcmp(memory + OAM_START + entry * 4, from + entry * 4, 4) != 0){
+                changed |= 1ULL << entry;
+            }
+        }
+        for(VideoDirty *dirty : videoWatchers){
+            dirty->oam |= changed;
+        }
+        memcpy(memory + OAM_START, from, OAM_SIZE);
+        videoGeneration++;
+    }
+
+    if(!dmaActive){
+        memcpy(dmaReadPages, readPages, sizeof(readPages));
+        memcpy(dmaWritePages, writePages, sizeof(writePages));
+        for(int i = 0; i < IO_START / PAGE_SIZE; i++){
+            readPages[i] = nullptr;
+            writePages[i] = nullptr;
+        }
+        dmaActive = true;
+
+        if(blockCache){
+            // the cpu can't keep running cached code it's no longer able to read
+            blockCache->forceLookup();
+        }
+    }
+
+    scheduler->schedule(EVENT_DMA, scheduler->now + DMA_CYCLES);
+}
 
-    // serial blargg debug
-    if (address == 0xFF02 && content == 0x81){
-        //printf("%c", readByte(0xFF01));
+// vram and oam writes land here so every watcher knows which tile, map row or sprite changed
+void Memory::writeVideo(uint16_t address, uint8_t content){
+    if(memory[address] == content){
+        return;
     }
+    memory[address] = content;
+    videoGeneration++;
 
-    // blargg debug
-    if (address == 0xA000){
-        uint16_t i = 0xA000;
-        while(i < 0xA000 + 256 && memory[i] != '\0'){
-            //printf("%c\n", memory[i]);
-            i++;
+    if(address < TILE_MAP_START){
+        int tile = (address - VRAM_START) >> 4;
+        for(VideoDirty *dirty : videoWatchers){
+            dirty->tiles[tile >> 6] |= 1ULL << (tile & 63);
+        }
+    }
+    else if(address < VRAM_END){
+        int map = (address - TILE_MAP_START) / TILE_MAP_SIZE;
+        for(VideoDirty *dirty : videoWatchers){
+            dirty->mapRows[map] |= 1u << ((address >> 5) & 31);
+        }
+    }
+    else{
+        for(VideoDirty *dirty : videoWatchers){
+            dirty->oam |= 1ULL << ((address - OAM_START) >> 2);
         }
     }
-  
-    // this address range is to handle memory banking in cartridge
+}
+
+/**
+ * @brief
+ * Start setting bits in dirty. It has seen none of video memory yet, so
+ * everything starts out dirty.
+ */
+void Memory::watchVideo(VideoDirty *dirty){
+    dirty->markAll();
+    videoWatchers.push_back(dirty);
+    videoGeneration++;
+}
+
+void Memory::unwatchVideo(VideoDirty *dirty){
+    videoWatchers.erase(std::remove(videoWatchers.begin(), videoWatchers.end(), dirty), videoWatchers.end());
+}
+
+// for when video memory changes behind writeVideo's back, everything has to be looked at again
+void Memory::markAllVideoDirty(){
+    for(VideoDirty *dirty : videoWatchers){
+        dirty->markAll();
+    }
+    videoGeneration++;
+}
+
+void Memory::finishDMA(){
+    memcpy(readPages, dmaReadPages, sizeof(readPages));
+    memcpy(writePages, dmaWritePages, sizeof(writePages));
+    dmaActive = false;
+}
+
+void Memory::writeSlow(uint16_t address, uint8_t content){
+    if(dmaActive && address < IO_START){
+        // the bus is busy with the DMA
+        return;
+    }
+
+    if(blockCache && blockCache->codeInPage[address >> 8] && (address < IO_START || address >= IO_START + IO_COUNT)){
+        blockCache->invalidatePage(address >> 8);
+    }
+
+    // this address range is to handle memory banking in cartridge, the cpu only
+    // has to look its block up again if the bank really changed
     if(address < 0x8000){
+        uint16_t bank = cartridge->getRomBank();
+        cartridge->writeCartridge(address, content);
+        if(cartridge->getRomBank() != bank){
+            mapRomBank();
+            if(blockCache){
+                blockCache->romBankChanged();
+            }
+        }
+        return;
+    }
+    else if(address >= 0xA000 && address <= 0xBFFF){
+        // external ram or the rtc, whichever the mbc has selected
         cartridge->writeCartridge(address, content);
         return;
     }
+    else if((address >= VRAM_START && address < VRAM_END) || (address >= OAM_START && address < OAM_START + OAM_SIZE)){
+        writeVideo(address, content);
+        return;
+    }
     else if(address >= 0xC000 && address <= 0xDDFF){
         // send to echo ram as well
         memory[address] = content;
@@ -58,20 +228,23 @@ void Memory::writeByte(uint16_t address, uint8_t content){
         //std::cout << "prohibited memory access: 0x" << std::hex << address << std::endl;
         return;
     }
-    else if(address == DIV){
-        // writing to the divider register resets it
-        memory[DIV] = 0;
-    }
-    else if (address == LY){
-        // writing to LCD Y coord/current scanline resets it 
-        memory[LY] = 0;
-    }
-    else if(address == 0xFF46){
-        // DMA transfer
-        for(int i = 0; i < 0xA0; i++){
-            memory[0xFE00 + i] = readByte((content << 8) + i);
+    else if(address >= IO_START && address < IO_START + IO_COUNT){
+#ifdef MEMORY_PROFILE
+        profile.ioWrites[address - IO_START]++;
+#endif
+        if(address == INTERRUPT_FLAG){
+            interruptCheckDue = true;
+        }
+        IORegister &reg = io[address - IO_START];
+        content = (memory[address] & ~reg.writeMask) | (content & reg.writeMask);
+        if(reg.write){
+            reg.write(address, content);
+            return;
         }
     }
+    else if(address == INTERRUPT_ENABLE){
+        interruptCheckDue = true;
+    }
 
     memory[address] = content;
 }
@@ -81,22 +254,28 @@ void Memory::writeWord(uint16_t address, uint16_t content){
     writeByte(address + 1, (uint8_t) (content >> 8));
 }
 
-u_int8_t Memory::readByte(uint16_t address){
-    if (address >= 0x4000 && address <= 0x7FFF){
-        return cartridge->readCartridge(address);
+uint8_t Memory::readSlow(uint16_t address){
+    if(dmaActive && address < IO_START){
+        return 0xFF;
     }
 
-    if (address >= 0xA000 && address <= 0xBFFF){
-        return cartridge->readCartridge(address);
+    if (address >= IO_START && address < IO_START + IO_COUNT){
+#ifdef MEMORY_PROFILE
+        profile.ioReads[address - IO_START]++;
+#endif
+        IORegister &reg = io[address - IO_START];
+        if(reg.read){
+            return reg.read(address);
+        }
     }
-
-    if (address == 0xFF00){
-        return joypad->getJoypad(memory[0xFF00]);
+    else if (address >= 0xA000 && address <= 0xBFFF){
+        return cartridge->readCartridge(address);
     }
 
+    // hram, IE and plain IO registers
     return memory[address];
 }
 
-u_int16_t Memory::readWord(uint16_t address){
+uint16_t Memory::readWord(uint16_t address){
     return ((uint16_t) readByte(address)) | ((uint16_t) readByte(address + 1) << 8);
 }
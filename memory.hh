@@ -1,9 +1,15 @@
 #pragma once
 
 #include <iostream>
+#include <functional>
+#include <cstring>
+#include <vector>
 
 #include "cartridge.hh"
 #include "joypad.hh"
+#include "blockcache.hh"
+#include "scheduler.hh"
+#include "memprofile.hh"
 
 #define DIV 0xFF04
 #define TIMA 0xFF05
@@ -12,23 +18,233 @@
 
 #define LY 0xFF44
 
+#define INTERRUPT_FLAG 0xFF0F
+#define INTERRUPT_ENABLE 0xFFFF
+
 #define JOYPAD_REGISTER 0xFF00
+#define DMA 0xFF46
+
+// OAM DMA copies 160 bytes, one every M-cycle
+#define OAM_START 0xFE00
+#define OAM_SIZE 0xA0
+#define DMA_CYCLES 640
+
+// vram holds 384 16 byte tiles, then two 32x32 tile maps
+#define VRAM_START 0x8000
+#define TILE_MAP_START 0x9800
+#define TILE_MAP_SIZE 0x400
+#define VRAM_END 0xA000
+#define TILE_COUNT 384
+#define OAM_ENTRIES 40
+
+// IO registers, 0xFF00-0xFF7F
+#define IO_START 0xFF00
+#define IO_COUNT 0x80
+
+// the memory map is split into 256 byte pages, one table entry each
+#define PAGE_SIZE 0x100
+#define PAGE_COUNT 0x100
+
+/**
+ * @brief
+ * What changed in vram and oam since the owner last cleared it: a bit per
+ * tile, per 32 byte row of each tile map and per oam entry. Every render
+ * cache keeps its own and registers it with Memory::watchVideo, Memory sets
+ * bits in all of them and each owner only ever clears its own.
+ */
+struct VideoDirty{
+    uint64_t tiles[TILE_COUNT / 64] = {0};
+    // bit n is row n of the map, one word for 0x9800 and one for 0x9C00
+    uint32_t mapRows[2] = {0};
+    uint64_t oam = 0;
+
+    bool tile(int tile){
+        return tiles[tile >> 6] & (1ULL << (tile & 63));
+    }
+
+    bool mapRow(int map, int row){
+        return mapRows[map] & (1u << row);
+    }
+
+    bool oamEntry(int entry){
+        return oam & (1ULL << entry);
+    }
+
+    void clear(){
+        memset(tiles, 0, sizeof(tiles));
+        memset(mapRows, 0, sizeof(mapRows));
+        oam = 0;
+    }
+
+    void markAll(){
+        memset(tiles, 0xFF, sizeof(tiles));
+        memset(mapRows, 0xFF, sizeof(mapRows));
+        oam = (1ULL << OAM_ENTRIES) - 1;
+    }
+};
 
 class Memory{
     public:
-        Memory(Cartridge *cartridge, Joypad *joypad);
+        Memory(Cartridge *cartridge, Joypad *joypad, Scheduler *scheduler);
+
+        uint8_t memory[0x10000] = {0};
+
+        // host memory behind each page, nullptr sends the access through readSlow/writeSlow.
+        // rom bank switches repoint the rom pages, vram, oam and pages holding cached code are left
+        // out of writePages
+        const uint8_t *readPages[PAGE_COUNT];
+        uint8_t *writePages[PAGE_COUNT];
+
+        // decoded code blocks, writes over cached code invalidate them
+        BlockCache *blockCache = nullptr;
+
+        // while an OAM DMA runs the cpu can only reach IO and HRAM, every other page goes
+        // through the slow path and the real tables are kept in dmaReadPages/dmaWritePages
+        bool dmaActive = false;
+
+        // set by anything that can make an interrupt due: a write to IF or IE, a requested
+        // interrupt, IME coming on or the cpu halting. The cpu only looks at IE & IF when it's set
+        bool interruptCheckDue = true;
+
+        // goes up whenever a write changes vram or oam, a watcher whose last seen value
+        // still matches has nothing to look at in its VideoDirty
+        uint64_t videoGeneration = 0;
 
-        uint8_t memory[0xFFFF];
+        void watchVideo(VideoDirty *dirty);
+        void unwatchVideo(VideoDirty *dirty);
+        void markAllVideoDirty();
+
+#ifdef MEMORY_PROFILE
+        MemoryProfile profile;
+#endif
+
+        /**
+         * @brief
+         * What happens on an access to an IO register. Without a read handler the
+         * value in memory is returned. Only the bits in writeMask are changed by a
+         * write, and the write handler gets the merged value and stores it. Without
+         * a handler the merged value is stored as is.
+         */
+        struct IORegister{
+            std::function<uint8_t(uint16_t address)> read;
+            std::function<void(uint16_t address, uint8_t content)> write;
+            uint8_t writeMask = 0xFF;
+        };
+        IORegister io[IO_COUNT];
+
+        void registerIO(uint16_t address, std::function<uint8_t(uint16_t)> read, std::function<void(uint16_t, uint8_t)> write, uint8_t writeMask = 0xFF);
         
-        void loadCartridge();
         void handleRomBanking(uint16_t address, uint8_t content);
 
-        void writeByte(uint16_t address, uint8_t content);
+        void mapRomBank();
+        void protectPage(uint8_t page, bool code);
+
+        void startDMA(uint8_t source);
+        void finishDMA();
+
+        // plain memory is a single table lookup, IO and the cartridge's ram go through the slow path
+        uint8_t readByte(uint16_t address){
+#ifdef MEMORY_PROFILE
+            profile.reads[address >> 8]++;
+#endif
+            const uint8_t *page = readPages[address >> 8];
+            if(page){
+                return page[address & 0xFF];
+            }
+            return readSlow(address);
+        }
+
+        void writeByte(uint16_t address, uint8_t content){
+#ifdef MEMORY_PROFILE
+            profile.writes[address >> 8]++;
+#endif
+            uint8_t *page = writePages[address >> 8];
+            if(page){
+                page[address & 0xFF] = content;
+                if(address >= 0xC000 && address <= 0xDDFF){
+                    // echo ram
+                    memory[address + 0x2000] = content;
+                }
+                return;
+            }
+            writeSlow(address, content);
+        }
+
+        /**
+         * @brief
+         * readByte for the emulator looking at guest memory, decoding an idle
+         * loop for instance. Nothing is counted in the memory profile and IO
+         * registers are read as stored, without their read handlers.
+         */
+        uint8_t peekByte(uint16_t address){
+            const uint8_t *page = readPages[address >> 8];
+            if(page){
+                return page[address & 0xFF];
+            }
+            if(address >= IO_START && address < IO_START + IO_COUNT){
+                return memory[address];
+            }
+            return readSlow(address);
+        }
+
+        uint16_t peekWord(uint16_t address){
+            return peekByte(address) | (peekByte(address + 1) << 8);
+        }
+
+        uint8_t readSlow(uint16_t address);
+        void writeSlow(uint16_t address, uint8_t content);
+
         void writeWord(uint16_t address, uint16_t content);
-        
-        uint8_t readByte(uint16_t address);
         uint16_t readWord(uint16_t address);
+
+        /**
+         * @brief
+         * Read-modify-write of a single byte. Pages that are read and written
+         * straight from the same memory are changed in place, and so is HRAM.
+         * Everything else goes through readByte and writeByte.
+         */
+        template<typename Modify>
+        void modifyByte(uint16_t address, Modify modify){
+            uint8_t *page = writePages[address >> 8];
+            if(page && page == readPages[address >> 8]){
+#ifdef MEMORY_PROFILE
+                profile.reads[address >> 8]++;
+                profile.writes[address >> 8]++;
+#endif
+                modify(page[address & 0xFF]);
+                if(address >= 0xC000 && address <= 0xDDFF){
+                    // echo ram
+                    memory[address + 0x2000] = page[address & 0xFF];
+                }
+                return;
+            }
+
+            // hram shares its page with IO so it has no page table entry, but
+            // only IE needs the slow path. Cached code in it still has to go
+            if(address >= IO_START + IO_COUNT && address < INTERRUPT_ENABLE && !(blockCache && blockCache->codeInPage[address >> 8])){
+#ifdef MEMORY_PROFILE
+                profile.reads[address >> 8]++;
+                profile.writes[address >> 8]++;
+#endif
+                modify(memory[address]);
+                return;
+            }
+
+            uint8_t content = readByte(address);
+            modify(content);
+            writeByte(address, content);
+        }
     private:
         Cartridge *cartridge;
         Joypad *joypad;
+        Scheduler *scheduler;
+
+        const uint8_t *dmaReadPages[PAGE_COUNT];
+        uint8_t *dmaWritePages[PAGE_COUNT];
+
+        // every VideoDirty registered with watchVideo, the ppu's and any others
+        std::vector<VideoDirty *> videoWatchers;
+
+        uint8_t *defaultWritePage(uint8_t page);
+        void writeVideo(uint16_t address, uint8_t content);
 };
\ No newline at end of file
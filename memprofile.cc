@@ -0,0 +1,47 @@
+#include <cstdio>
+
+#include "memprofile.hh"
+
+bool MemoryProfile::dump(std::string filename){
+    FILE *file = fopen(filename.c_str(), "w");
+    if(file == nullptr){
+        std::cout << "could not open " << filename << " for the memory profile" << std::endl;
+        return false;
+    }
+
+    bool json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+    if(json){
+        writeJSON(file);
+    }
+    else{
+        writeCSV(file);
+    }
+
+    fclose(file);
+    return true;
+}
+
+void MemoryProfile::writeCSV(FILE *file){
+    fprintf(file, "kind,address,reads,writes,fetches\n");
+    for(int page = 0; page < PROFILE_PAGES; page++){
+        fprintf(file, "page,0x%04X,%llu,%llu,%llu\n", page << 8, (unsigned long long) reads[page], (unsigned long long) writes[page], (unsigned long long) fetches[page]);
+    }
+    // IO registers aren't fetched from
+    for(int reg = 0; reg < PROFILE_IO_REGISTERS; reg++){
+        fprintf(file, "io,0x%04X,%llu,%llu,0\n", 0xFF00 + reg, (unsigned long long) ioReads[reg], (unsigned long long) ioWrites[reg]);
+    }
+}
+
+void MemoryProfile::writeJSON(FILE *file){
+    fprintf(file, "{\n  \"pages\": [\n");
+    for(int page = 0; page < PROFILE_PAGES; page++){
+        fprintf(file, "    {\"address\": %d, \"reads\": %llu, \"writes\": %llu, \"fetches\": %llu}%s\n", page << 8,
+            (unsigned long long) reads[page], (unsigned long long) writes[page], (unsigned long long) fetches[page], page == PROFILE_PAGES - 1 ? "" : ",");
+    }
+    fprintf(file, "  ],\n  \"io\": [\n");
+    for(int reg = 0; reg < PROFILE_IO_REGISTERS; reg++){
+        fprintf(file, "    {\"address\": %d, \"reads\": %llu, \"writes\": %llu}%s\n", 0xFF00 + reg,
+            (unsigned long long) ioReads[reg], (unsigned long long) ioWrites[reg], reg == PROFILE_IO_REGISTERS - 1 ? "" : ",");
+    }
+    fprintf(file, "  ]\n}\n");
+}
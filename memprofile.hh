@@ -0,0 +1,38 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+// one counter per 256 byte page and per IO register, same split as Memory's page tables
+#define PROFILE_PAGES 0x100
+#define PROFILE_IO_REGISTERS 0x80
+
+/**
+ * @brief
+ * Counts of how the game uses the memory map. Compiled in with MEMORY_PROFILE
+ * (make MEMORY_PROFILE=1), a normal build has no counters and no increments.
+ * Each Memory counts into its own profile with plain increments, nothing on
+ * the hot path is shared between emulator instances.
+ *
+ * Reads and writes are every access through Memory, including the opcode
+ * fetches the interpreter makes. Fetches are one per instruction executed, by
+ * the page the instruction started in, whether it came out of the block cache
+ * or not. Only the game's accesses are counted, the emulator's own interrupt
+ * checks and idle loop decoding read memory directly or through peekByte.
+ */
+struct MemoryProfile{
+    uint64_t reads[PROFILE_PAGES] = {0};
+    uint64_t writes[PROFILE_PAGES] = {0};
+    uint64_t fetches[PROFILE_PAGES] = {0};
+    uint64_t ioReads[PROFILE_IO_REGISTERS] = {0};
+    uint64_t ioWrites[PROFILE_IO_REGISTERS] = {0};
+
+    // JSON if the filename ends in .json, CSV otherwise
+    bool dump(std::string filename);
+
+    private:
+        void writeCSV(FILE *file);
+        void writeJSON(FILE *file);
+};
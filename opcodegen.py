@@ -0,0 +1,138 @@
+import json
+
+# Generates opcodes.hh, the opcode metadata the cpu, the tracer and anything
+# else that needs to know about instructions reads from.
+#
+# The unprefixed opcodes come from the archived opcodeTable.json (see
+# opcodescraper.py). The CB prefixed opcodes are regular enough that they are
+# built here instead of being scraped.
+#
+# usage: python3 opcodegen.py
+
+REGISTERS = ["B", "C", "D", "E", "H", "L", "(HL)", "A"]
+ILLEGAL_OPCODES = [0xd3, 0xdb, 0xdd, 0xe3, 0xe4, 0xeb, 0xec, 0xed, 0xf4, 0xfc, 0xfd]
+
+# instructions that can leave the program counter anywhere but the next instruction
+CONTROL_FLOW = ["JR", "JP", "CALL", "RET", "RETI", "RST", "HALT", "STOP", "ILLEGAL"]
+
+def parseTiming(timing):
+    # conditional instructions list the not taken time first, ie; 8t-12t
+    times = [int(t.strip("t")) for t in timing.split("-")]
+    if len(times) == 1:
+        return times[0], 0
+    return times[0], times[1]
+
+def unprefixedOpcodes():
+    with open('opcodeTable.json') as f:
+        operations = json.load(f)
+
+    opcodes = [None] * 256
+    for operation in operations:
+        code = int(operation["code"], 16)
+        cycles, branchCycles = parseTiming(operation["timing"])
+        mnemonic = operation["mnemonic"]
+        if operation["args"]:
+            mnemonic += " " + ", ".join(operation["args"])
+
+        opcodes[code] = {
+            "mnemonic": mnemonic,
+            "length": int(operation["length"]),
+            "cycles": cycles,
+            "branchCycles": branchCycles,
+            "flags": "".join(operation["flags"]),
+        }
+
+    for code in ILLEGAL_OPCODES:
+        opcodes[code] = {"mnemonic": "ILLEGAL", "length": 1, "cycles": 0, "branchCycles": 0, "flags": "----"}
+
+    assert all(opcodes), "opcodeTable.json is missing opcodes"
+    return opcodes
+
+def prefixedOpcodes():
+    shifts = [
+        ("RLC", "Z00C"), ("RRC", "Z00C"), ("RL", "Z00C"), ("RR", "Z00C"),
+        ("SLA", "Z00C"), ("SRA", "Z00C"), ("SWAP", "Z000"), ("SRL", "Z00C"),
+    ]
+
+    opcodes = []
+    for code in range(256):
+        register = REGISTERS[code & 0x7]
+        group = code >> 6
+        n = (code >> 3) & 0x7
+
+        if group == 0:
+            mnemonic, flags = shifts[n]
+            mnemonic = f"{mnemonic} {register}"
+            cycles = 16 if register == "(HL)" else 8
+        elif group == 1:
+            mnemonic = f"BIT {n}, {register}"
+            flags = "Z01-"
+            cycles = 12 if register == "(HL)" else 8
+        else:
+            mnemonic = f"{'RES' if group == 2 else 'SET'} {n}, {register}"
+            flags = "----"
+            cycles = 16 if register == "(HL)" else 8
+
+        opcodes.append({"mnemonic": mnemonic, "length": 2, "cycles": cycles, "branchCycles": 0, "flags": flags})
+    return opcodes
+
+def flagMask(flags):
+    # bit positions match the F register, Z N H C from bit 7 down
+    mask = 0
+    for i, flag in enumerate(flags):
+        if flag != "-":
+            mask |= 1 << (7 - i)
+    return mask
+
+def table(name, opcodes):
+    res = f"constexpr OpcodeInfo {name}[256] = {{\n"
+    for code, op in enumerate(opcodes):
+        controlFlow = "true" if op["mnemonic"].split(" ")[0] in CONTROL_FLOW else "false"
+        res += f"    {{\"{op['mnemonic']}\", {op['length']}, {op['cycles']}, {op['branchCycles']}, \"{op['flags']}\", 0x{flagMask(op['flags']):02x}, {controlFlow}}}, // 0x{code:02x}\n"
+    res += "};\n"
+    return res
+
+def labels(name, opcodes):
+    entries = []
+    for code, op in enumerate(opcodes):
+        entries.append("&&op_illegal" if op["mnemonic"] == "ILLEGAL" else f"&&op_0x{code:02x}")
+
+    res = f"#define {name} {{ \\\n"
+    for i in range(0, 256, 8):
+        res += "    " + ", ".join(entries[i:i + 8]) + ("" if i == 248 else ",") + " \\\n"
+    res += "}\n"
+    return res
+
+unprefixed = unprefixedOpcodes()
+prefixed = prefixedOpcodes()
+
+header = """#pragma once
+
+#include <iostream>
+
+// GENERATED by opcodegen.py from opcodeTable.json, do not edit by hand
+
+struct OpcodeInfo{
+    const char *mnemonic;
+    uint8_t length;
+    // cycles when a conditional instruction does not branch
+    uint8_t cycles;
+    // cycles when a conditional instruction branches, 0 if it never does
+    uint8_t branchCycles;
+    // Z N H C, as written in the opcode tables
+    const char *flags;
+    // flag bits the instruction can change
+    uint8_t flagsAffected;
+    // the instruction can move the program counter somewhere other than the next instruction
+    bool controlFlow;
+};
+
+"""
+
+header += table("opcodeTable", unprefixed) + "\n"
+header += table("prefixOpcodeTable", prefixed) + "\n"
+header += "// computed goto targets for the cpu's opcode dispatch, in opcode order\n"
+header += labels("OPCODE_LABELS", unprefixed)
+
+with open('opcodes.hh', 'w') as f:
+    f.write(header)
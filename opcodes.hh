@@ -0,0 +1,574 @@
+#pragma once
+
+#include <iostream>
+
+// GENERATED by opcodegen.py from opcodeTable.json, do not edit by hand
+
+struct OpcodeInfo{
+    const char *mnemonic;
+    uint8_t length;
+    // cycles when a conditional instruction does not branch
+    uint8_t cycles;
+    // cycles when a conditional instruction branches, 0 if it never does
+    uint8_t branchCycles;
+    // Z N H C, as written in the opcode tables
+    const char *flags;
+    // flag bits the instruction can change
+    uint8_t flagsAffected;
+    // the instruction can move the program counter somewhere other than the next instruction
+    bool controlFlow;
+};
+
+constexpr OpcodeInfo opcodeTable[256] = {
+    {"NOP", 1, 4, 0, "----", 0x00, false}, // 0x00
+    {"LD BC, u16", 3, 12, 0, "----", 0x00, false}, // 0x01
+    {"LD (BC), A", 1, 8, 0, "----", 0x00, false}, // 0x02
+    {"INC BC", 1, 8, 0, "----", 0x00, false}, // 0x03
+    {"INC B", 1, 4, 0, "Z0H-", 0xe0, false}, // 0x04
+    {"DEC B", 1, 4, 0, "Z1H-", 0xe0, false}, // 0x05
+    {"LD B, u8", 2, 8, 0, "----", 0x00, false}, // 0x06
+    {"RLCA", 1, 4, 0, "000C", 0xf0, false}, // 0x07
+    {"LD (u16), SP", 3, 20, 0, "----", 0x00, false}, // 0x08
+    {"ADD HL, BC", 1, 8, 0, "-0HC", 0x70, false}, // 0x09
+    {"LD A, (BC)", 1, 8, 0, "----", 0x00, false}, // 0x0a
+    {"DEC BC", 1, 8, 0, "----", 0x00, false}, // 0x0b
+    {"INC C", 1, 4, 0, "Z0H-", 0xe0, false}, // 0x0c
+    {"DEC C", 1, 4, 0, "Z1H-", 0xe0, false}, // 0x0d
+    {"LD C, u8", 2, 8, 0, "----", 0x00, false}, // 0x0e
+    {"RRCA", 1, 4, 0, "000C", 0xf0, false}, // 0x0f
+    {"STOP", 1, 4, 0, "----", 0x00, true}, // 0x10
+    {"LD DE, u16", 3, 12, 0, "----", 0x00, false}, // 0x11
+    {"LD (DE), A", 1, 8, 0, "----", 0x00, false}, // 0x12
+    {"INC DE", 1, 8, 0, "----", 0x00, false}, // 0x13
+    {"INC D", 1, 4, 0, "Z0H-", 0xe0, false}, // 0x14
+    {"DEC D", 1, 4, 0, "Z1H-", 0xe0, false}, // 0x15
+    {"LD D, u8", 2, 8, 0, "----", 0x00, false}, // 0x16
+    {"RLA", 1, 4, 0, "000C", 0xf0, false}, // 0x17
+    {"JR i8", 2, 12, 0, "----", 0x00, true}, // 0x18
+    {"ADD HL, DE", 1, 8, 0, "-0HC", 0x70, false}, // 0x19
+    {"LD A, (DE)", 1, 8, 0, "----", 0x00, false}, // 0x1a
+    {"DEC DE", 1, 8, 0, "----", 0x00, false}, // 0x1b
+    {"INC E", 1, 4, 0, "Z0H-", 0xe0, false}, // 0x1c
+    {"DEC E", 1, 4, 0, "Z1H-", 0xe0, false}, // 0x1d
+    {"LD E, u8", 2, 8, 0, "----", 0x00, false}, // 0x1e
+    {"RRA", 1, 4, 0, "000C", 0xf0, false}, // 0x1f
+    {"JR NZ, i8", 2, 8, 12, "----", 0x00, true}, // 0x20
+    {"LD HL, u16", 3, 12, 0, "----", 0x00, false}, // 0x21
+    {"LD (HL+), A", 1, 8, 0, "----", 0x00, false}, // 0x22
+    {"INC HL", 1, 8, 0, "----", 0x00, false}, // 0x23
+    {"INC H", 1, 4, 0, "Z0H-", 0xe0, false}, // 0x24
+    {"DEC H", 1, 4, 0, "Z1H-", 0xe0, false}, // 0x25
+    {"LD H, u8", 2, 8, 0, "----", 0x00, false}, // 0x26
+    {"DAA", 1, 4, 0, "Z-0C", 0xb0, false}, // 0x27
+    {"JR Z, i8", 2, 8, 12, "----", 0x00, true}, // 0x28
+    {"ADD HL, HL", 1, 8, 0, "-0HC", 0x70, false}, // 0x29
+    {"LD A, (HL+)", 1, 8, 0, "----", 0x00, false}, // 0x2a
+    {"DEC HL", 1, 8, 0, "----", 0x00, false}, // 0x2b
+    {"INC L", 1, 4, 0, "Z0H-", 0xe0, false}, // 0x2c
+    {"DEC L", 1, 4, 0, "Z1H-", 0xe0, false}, // 0x2d
+    {"LD L, u8", 2, 8, 0, "----", 0x00, false}, // 0x2e
+    {"CPL", 1, 4, 0, "-11-", 0x60, false}, // 0x2f
+    {"JR NC, i8", 2, 8, 12, "----", 0x00, true}, // 0x30
+    {"LD SP, u16", 3, 12, 0, "----", 0x00, false}, // 0x31
+    {"LD (HL-), A", 1, 8, 0, "----", 0x00, false}, // 0x32
+    {"INC SP", 1, 8, 0, "----", 0x00, false}, // 0x33
+    {"INC (HL)", 1, 12, 0, "Z0H-", 0xe0, false}, // 0x34
+    {"DEC (HL)", 1, 12, 0, "Z1H-", 0xe0, false}, // 0x35
+    {"LD (HL), u8", 2, 12, 0, "----", 0x00, false}, // 0x36
+    {"SCF", 1, 4, 0, "-001", 0x70, false}, // 0x37
+    {"JR C, i8", 2, 8, 12, "----", 0x00, true}, // 0x38
+    {"ADD HL, SP", 1, 8, 0, "-0HC", 0x70, false}, // 0x39
+    {"LD A, (HL-)", 1, 8, 0, "----", 0x00, false}, // 0x3a
+    {"DEC SP", 1, 8, 0, "----", 0x00, false}, // 0x3b
+    {"INC A", 1, 4, 0, "Z0H-", 0xe0, false}, // 0x3c
+    {"DEC A", 1, 4, 0, "Z1H-", 0xe0, false}, // 0x3d
+    {"LD A, u8", 2, 8, 0, "----", 0x00, false}, // 0x3e
+    {"CCF", 1, 4, 0, "-00C", 0x70, false}, // 0x3f
+    {"LD B, B", 1, 4, 0, "----", 0x00, false}, // 0x40
+    {"LD B, C", 1, 4, 0, "----", 0x00, false}, // 0x41
+    {"LD B, D", 1, 4, 0, "----", 0x00, false}, // 0x42
+    {"LD B, E", 1, 4, 0, "----", 0x00, false}, // 0x43
+    {"LD B, H", 1, 4, 0, "----", 0x00, false}, // 0x44
+    {"LD B, L", 1, 4, 0, "----", 0x00, false}, // 0x45
+    {"LD B, (HL)", 1, 8, 0, "----", 0x00, false}, // 0x46
+    {"LD B, A", 1, 4, 0, "----", 0x00, false}, // 0x47
+    {"LD C, B", 1, 4, 0, "----", 0x00, false}, // 0x48
+    {"LD C, C", 1, 4, 0, "----", 0x00, false}, // 0x49
+    {"LD C, D", 1, 4, 0, "----", 0x00, false}, // 0x4a
+    {"LD C, E", 1, 4, 0, "----", 0x00, false}, // 0x4b
+    {"LD C, H", 1, 4, 0, "----", 0x00, false}, // 0x4c
+    {"LD C, L", 1, 4, 0, "----", 0x00, false}, // 0x4d
+    {"LD C, (HL)", 1, 8, 0, "----", 0x00, false}, // 0x4e
+    {"LD C, A", 1, 4, 0, "----", 0x00, false}, // 0x4f
+    {"LD D, B", 1, 4, 0, "----", 0x00, false}, // 0x50
+    {"LD D, C", 1, 4, 0, "----", 0x00, false}, // 0x51
+    {"LD D, D", 1, 4, 0, "----", 0x00, false}, // 0x52
+    {"LD D, E", 1, 4, 0, "----", 0x00, false}, // 0x53
+    {"LD D, H", 1, 4, 0, "----", 0x00, false}, // 0x54
+    {"LD D, L", 1, 4, 0, "----", 0x00, false}, // 0x55
+    {"LD D, (HL)", 1, 8, 0, "----", 0x00, false}, // 0x56
+    {"LD D, A", 1, 4, 0, "----", 0x00, false}, // 0x57
+    {"LD E, B", 1, 4, 0, "----", 0x00, false}, // 0x58
+    {"LD E, C", 1, 4, 0, "----", 0x00, false}, // 0x59
+    {"LD E, D", 1, 4, 0, "----", 0x00, false}, // 0x5a
+    {"LD E, E", 1, 4, 0, "----", 0x00, false}, // 0x5b
+    {"LD E, H", 1, 4, 0, "----", 0x00, false}, // 0x5c
+    {"LD E, L", 1, 4, 0, "----", 0x00, false}, // 0x5d
+    {"LD E, (HL)", 1, 8, 0, "----", 0x00, false}, // 0x5e
+    {"LD E, A", 1, 4, 0, "----", 0x00, false}, // 0x5f
+    {"LD H, B", 1, 4, 0, "----", 0x00, false}, // 0x60
+    {"LD H, C", 1, 4, 0, "----", 0x00, false}, // 0x61
+    {"LD H, D", 1, 4, 0, "----", 0x00, false}, // 0x62
+    {"LD H, E", 1, 4, 0, "----", 0x00, false}, // 0x63
+    {"LD H, H", 1, 4, 0, "----", 0x00, false}, // 0x64
+    {"LD H, L", 1, 4, 0, "----", 0x00, false}, // 0x65
+    {"LD H, (HL)", 1, 8, 0, "----", 0x00, false}, // 0x66
+    {"LD H, A", 1, 4, 0, "----", 0x00, false}, // 0x67
+    {"LD L, B", 1, 4, 0, "----", 0x00, false}, // 0x68
+    {"LD L, C", 1, 4, 0, "----", 0x00, false}, // 0x69
+    {"LD L, D", 1, 4, 0, "----", 0x00, false}, // 0x6a
+    {"LD L, E", 1, 4, 0, "----", 0x00, false}, // 0x6b
+    {"LD L, H", 1, 4, 0, "----", 0x00, false}, // 0x6c
+    {"LD L, L", 1, 4, 0, "----", 0x00, false}, // 0x6d
+    {"LD L, (HL)", 1, 8, 0, "----", 0x00, false}, // 0x6e
+    {"LD L, A", 1, 4, 0, "----", 0x00, false}, // 0x6f
+    {"LD (HL), B", 1, 8, 0, "----", 0x00, false}, // 0x70
+    {"LD (HL), C", 1, 8, 0, "----", 0x00, false}, // 0x71
+    {"LD (HL), D", 1, 8, 0, "----", 0x00, false}, // 0x72
+    {"LD (HL), E", 1, 8, 0, "----", 0x00, false}, // 0x73
+    {"LD (HL), H", 1, 8, 0, "----", 0x00, false}, // 0x74
+    {"LD (HL), L", 1, 8, 0, "----", 0x00, false}, // 0x75
+    {"HALT", 1, 4, 0, "----", 0x00, true}, // 0x76
+    {"LD (HL), A", 1, 8, 0, "----", 0x00, false}, // 0x77
+    {"LD A, B", 1, 4, 0, "----", 0x00, false}, // 0x78
+    {"LD A, C", 1, 4, 0, "----", 0x00, false}, // 0x79
+    {"LD A, D", 1, 4, 0, "----", 0x00, false}, // 0x7a
+    {"LD A, E", 1, 4, 0, "----", 0x00, false}, // 0x7b
+    {"LD A, H", 1, 4, 0, "----", 0x00, false}, // 0x7c
+    {"LD A, L", 1, 4, 0, "----", 0x00, false}, // 0x7d
+    {"LD A, (HL)", 1, 8, 0, "----", 0x00, false}, // 0x7e
+    {"LD A, A", 1, 4, 0, "----", 0x00, false}, // 0x7f
+    {"ADD A, B", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x80
+    {"ADD A, C", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x81
+    {"ADD A, D", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x82
+    {"ADD A, E", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x83
+    {"ADD A, H", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x84
+    {"ADD A, L", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x85
+    {"ADD A, (HL)", 1, 8, 0, "Z0HC", 0xf0, false}, // 0x86
+    {"ADD A, A", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x87
+    {"ADC A, B", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x88
+    {"ADC A, C", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x89
+    {"ADC A, D", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x8a
+    {"ADC A, E", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x8b
+    {"ADC A, H", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x8c
+    {"ADC A, L", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x8d
+    {"ADC A, (HL)", 1, 8, 0, "Z0HC", 0xf0, false}, // 0x8e
+    {"ADC A, A", 1, 4, 0, "Z0HC", 0xf0, false}, // 0x8f
+    {"SUB A, B", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x90
+    {"SUB A, C", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x91
+    {"SUB A, D", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x92
+    {"SUB A, E", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x93
+    {"SUB A, H", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x94
+    {"SUB A, L", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x95
+    {"SUB A, (HL)", 1, 8, 0, "Z1HC", 0xf0, false}, // 0x96
+    {"SUB A, A", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x97
+    {"SBC A, B", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x98
+    {"SBC A, C", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x99
+    {"SBC A, D", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x9a
+    {"SBC A, E", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x9b
+    {"SBC A, H", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x9c
+    {"SBC A, L", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x9d
+    {"SBC A, (HL)", 1, 8, 0, "Z1HC", 0xf0, false}, // 0x9e
+    {"SBC A, A", 1, 4, 0, "Z1HC", 0xf0, false}, // 0x9f
+    {"AND A, B", 1, 4, 0, "Z010", 0xf0, false}, // 0xa0
+    {"AND A, C", 1, 4, 0, "Z010", 0xf0, false}, // 0xa1
+    {"AND A, D", 1, 4, 0, "Z010", 0xf0, false}, // 0xa2
+    {"AND A, E", 1, 4, 0, "Z010", 0xf0, false}, // 0xa3
+    {"AND A, H", 1, 4, 0, "Z010", 0xf0, false}, // 0xa4
+    {"AND A, L", 1, 4, 0, "Z010", 0xf0, false}, // 0xa5
+    {"AND A, (HL)", 1, 8, 0, "Z010", 0xf0, false}, // 0xa6
+    {"AND A, A", 1, 4, 0, "Z010", 0xf0, false}, // 0xa7
+    {"XOR A, B", 1, 4, 0, "Z000", 0xf0, false}, // 0xa8
+    {"XOR A, C", 1, 4, 0, "Z000", 0xf0, false}, // 0xa9
+    {"XOR A, D", 1, 4, 0, "Z000", 0xf0, false}, // 0xaa
+    {"XOR A, E", 1, 4, 0, "Z000", 0xf0, false}, // 0xab
+    {"XOR A, H", 1, 4, 0, "Z000", 0xf0, false}, // 0xac
+    {"XOR A, L", 1, 4, 0, "Z000", 0xf0, false}, // 0xad
+    {"XOR A, (HL)", 1, 8, 0, "Z000", 0xf0, false}, // 0xae
+    {"XOR A, A", 1, 4, 0, "Z000", 0xf0, false}, // 0xaf
+    {"OR A, B", 1, 4, 0, "Z000", 0xf0, false}, // 0xb0
+    {"OR A, C", 1, 4, 0, "Z000", 0xf0, false}, // 0xb1
+    {"OR A, D", 1, 4, 0, "Z000", 0xf0, false}, // 0xb2
+    {"OR A, E", 1, 4, 0, "Z000", 0xf0, false}, // 0xb3
+    {"OR A, H", 1, 4, 0, "Z000", 0xf0, false}, // 0xb4
+    {"OR A, L", 1, 4, 0, "Z000", 0xf0, false}, // 0xb5
+    {"OR A, (HL)", 1, 8, 0, "Z000", 0xf0, false}, // 0xb6
+    {"OR A, A", 1, 4, 0, "Z000", 0xf0, false}, // 0xb7
+    {"CP A, B", 1, 4, 0, "Z1HC", 0xf0, false}, // 0xb8
+    {"CP A, C", 1, 4, 0, "Z1HC", 0xf0, false}, // 0xb9
+    {"CP A, D", 1, 4, 0, "Z1HC", 0xf0, false}, // 0xba
+    {"CP A, E", 1, 4, 0, "Z1HC", 0xf0, false}, // 0xbb
+    {"CP A, H", 1, 4, 0, "Z1HC", 0xf0, false}, // 0xbc
+    {"CP A, L", 1, 4, 0, "Z1HC", 0xf0, false}, // 0xbd
+    {"CP A, (HL)", 1, 8, 0, "Z1HC", 0xf0, false}, // 0xbe
+    {"CP A, A", 1, 4, 0, "Z1HC", 0xf0, false}, // 0xbf
+    {"RET NZ", 1, 8, 20, "----", 0x00, true}, // 0xc0
+    {"POP BC", 1, 12, 0, "----", 0x00, false}, // 0xc1
+    {"JP NZ, u16", 3, 12, 16, "----", 0x00, true}, // 0xc2
+    {"JP u16", 3, 16, 0, "----", 0x00, true}, // 0xc3
+    {"CALL NZ, u16", 3, 12, 24, "----", 0x00, true}, // 0xc4
+    {"PUSH BC", 1, 16, 0, "----", 0x00, false}, // 0xc5
+    {"ADD A, u8", 2, 8, 0, "Z0HC", 0xf0, false}, // 0xc6
+    {"RST 00h", 1, 16, 0, "----", 0x00, true}, // 0xc7
+    {"RET Z", 1, 8, 20, "----", 0x00, true}, // 0xc8
+    {"RET", 1, 16, 0, "----", 0x00, true}, // 0xc9
+    {"JP Z, u16", 3, 12, 16, "----", 0x00, true}, // 0xca
+    {"PREFIX CB", 1, 4, 0, "----", 0x00, false}, // 0xcb
+    {"CALL Z, u16", 3, 12, 24, "----", 0x00, true}, // 0xcc
+    {"CALL u16", 3, 24, 0, "----", 0x00, true}, // 0xcd
+    {"ADC A, u8", 2, 8, 0, "Z0HC", 0xf0, false}, // 0xce
+    {"RST 08h", 1, 16, 0, "----", 0x00, true}, // 0xcf
+    {"RET NC", 1, 8, 20, "----", 0x00, true}, // 0xd0
+    {"POP DE", 1, 12, 0, "----", 0x00, false}, // 0xd1
+    {"JP NC, u16", 3, 12, 16, "----", 0x00, true}, // 0xd2
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xd3
+    {"CALL NC, u16", 3, 12, 24, "----", 0x00, true}, // 0xd4
+    {"PUSH DE", 1, 16, 0, "----", 0x00, false}, // 0xd5
+    {"SUB A, u8", 2, 8, 0, "Z1HC", 0xf0, false}, // 0xd6
+    {"RST 10h", 1, 16, 0, "----", 0x00, true}, // 0xd7
+    {"RET C", 1, 8, 20, "----", 0x00, true}, // 0xd8
+    {"RETI", 1, 16, 0, "----", 0x00, true}, // 0xd9
+    {"JP C, u16", 3, 12, 16, "----", 0x00, true}, // 0xda
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xdb
+    {"CALL C, u16", 3, 12, 24, "----", 0x00, true}, // 0xdc
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xdd
+    {"SBC A, u8", 2, 8, 0, "Z1HC", 0xf0, false}, // 0xde
+    {"RST 18h", 1, 16, 0, "----", 0x00, true}, // 0xdf
+    {"LD (FF00+u8), A", 2, 12, 0, "----", 0x00, false}, // 0xe0
+    {"POP HL", 1, 12, 0, "----", 0x00, false}, // 0xe1
+    {"LD (FF00+C), A", 1, 8, 0, "----", 0x00, false}, // 0xe2
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xe3
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xe4
+    {"PUSH HL", 1, 16, 0, "----", 0x00, false}, // 0xe5
+    {"AND A, u8", 2, 8, 0, "Z010", 0xf0, false}, // 0xe6
+    {"RST 20h", 1, 16, 0, "----", 0x00, true}, // 0xe7
+    {"ADD SP, i8", 2, 16, 0, "00HC", 0xf0, false}, // 0xe8
+    {"JP HL", 1, 4, 0, "----", 0x00, true}, // 0xe9
+    {"LD (u16), A", 3, 16, 0, "----", 0x00, false}, // 0xea
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xeb
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xec
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xed
+    {"XOR A, u8", 2, 8, 0, "Z000", 0xf0, false}, // 0xee
+    {"RST 28h", 1, 16, 0, "----", 0x00, true}, // 0xef
+    {"LD A, (FF00+u8)", 2, 12, 0, "----", 0x00, false}, // 0xf0
+    {"POP AF", 1, 12, 0, "ZNHC", 0xf0, false}, // 0xf1
+    {"LD A, (FF00+C)", 1, 8, 0, "----", 0x00, false}, // 0xf2
+    {"DI", 1, 4, 0, "----", 0x00, false}, // 0xf3
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xf4
+    {"PUSH AF", 1, 16, 0, "----", 0x00, false}, // 0xf5
+    {"OR A, u8", 2, 8, 0, "Z000", 0xf0, false}, // 0xf6
+    {"RST 30h", 1, 16, 0, "----", 0x00, true}, // 0xf7
+    {"LD HL, SP+i8", 2, 12, 0, "00HC", 0xf0, false}, // 0xf8
+    {"LD SP, HL", 1, 8, 0, "----", 0x00, false}, // 0xf9
+    {"LD A, (u16)", 3, 16, 0, "----", 0x00, false}, // 0xfa
+    {"EI", 1, 4, 0, "----", 0x00, false}, // 0xfb
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xfc
+    {"ILLEGAL", 1, 0, 0, "----", 0x00, true}, // 0xfd
+    {"CP A, u8", 2, 8, 0, "Z1HC", 0xf0, false}, // 0xfe
+    {"RST 38h", 1, 16, 0, "----", 0x00, true}, // 0xff
+};
+
+constexpr OpcodeInfo prefixOpcodeTable[256] = {
+    {"RLC B", 2, 8, 0, "Z00C", 0xf0, false}, // 0x00
+    {"RLC C", 2, 8, 0, "Z00C", 0xf0, false}, // 0x01
+    {"RLC D", 2, 8, 0, "Z00C", 0xf0, false}, // 0x02
+    {"RLC E", 2, 8, 0, "Z00C", 0xf0, false}, // 0x03
+    {"RLC H", 2, 8, 0, "Z00C", 0xf0, false}, // 0x04
+    {"RLC L", 2, 8, 0, "Z00C", 0xf0, false}, // 0x05
+    {"RLC (HL)", 2, 16, 0, "Z00C", 0xf0, false}, // 0x06
+    {"RLC A", 2, 8, 0, "Z00C", 0xf0, false}, // 0x07
+    {"RRC B", 2, 8, 0, "Z00C", 0xf0, false}, // 0x08
+    {"RRC C", 2, 8, 0, "Z00C", 0xf0, false}, // 0x09
+    {"RRC D", 2, 8, 0, "Z00C", 0xf0, false}, // 0x0a
+    {"RRC E", 2, 8, 0, "Z00C", 0xf0, false}, // 0x0b
+    {"RRC H", 2, 8, 0, "Z00C", 0xf0, false}, // 0x0c
+    {"RRC L", 2, 8, 0, "Z00C", 0xf0, false}, // 0x0d
+    {"RRC (HL)", 2, 16, 0, "Z00C", 0xf0, false}, // 0x0e
+    {"RRC A", 2, 8, 0, "Z00C", 0xf0, false}, // 0x0f
+    {"RL B", 2, 8, 0, "Z00C", 0xf0, false}, // 0x10
+    {"RL C", 2, 8, 0, "Z00C", 0xf0, false}, // 0x11
+    {"RL D", 2, 8, 0, "Z00C", 0xf0, false}, // 0x12
+    {"RL E", 2, 8, 0, "Z00C", 0xf0, false}, // 0x13
+    {"RL H", 2, 8, 0, "Z00C", 0xf0, false}, // 0x14
+    {"RL L", 2, 8, 0, "Z00C", 0xf0, false}, // 0x15
+    {"RL (HL)", 2, 16, 0, "Z00C", 0xf0, false}, // 0x16
+    {"RL A", 2, 8, 0, "Z00C", 0xf0, false}, // 0x17
+    {"RR B", 2, 8, 0, "Z00C", 0xf0, false}, // 0x18
+    {"RR C", 2, 8, 0, "Z00C", 0xf0, false}, // 0x19
+    {"RR D", 2, 8, 0, "Z00C", 0xf0, false}, // 0x1a
+    {"RR E", 2, 8, 0, "Z00C", 0xf0, false}, // 0x1b
+    {"RR H", 2, 8, 0, "Z00C", 0xf0, false}, // 0x1c
+    {"RR L", 2, 8, 0, "Z00C", 0xf0, false}, // 0x1d
+    {"RR (HL)", 2, 16, 0, "Z00C", 0xf0, false}, // 0x1e
+    {"RR A", 2, 8, 0, "Z00C", 0xf0, false}, // 0x1f
+    {"SLA B", 2, 8, 0, "Z00C", 0xf0, false}, // 0x20
+    {"SLA C", 2, 8, 0, "Z00C", 0xf0, false}, // 0x21
+    {"SLA D", 2, 8, 0, "Z00C", 0xf0, false}, // 0x22
+    {"SLA E", 2, 8, 0, "Z00C", 0xf0, false}, // 0x23
+    {"SLA H", 2, 8, 0, "Z00C", 0xf0, false}, // 0x24
+    {"SLA L", 2, 8, 0, "Z00C", 0xf0, false}, // 0x25
+    {"SLA (HL)", 2, 16, 0, "Z00C", 0xf0, false}, // 0x26
+    {"SLA A", 2, 8, 0, "Z00C", 0xf0, false}, // 0x27
+    {"SRA B", 2, 8, 0, "Z00C", 0xf0, false}, // 0x28
+    {"SRA C", 2, 8, 0, "Z00C", 0xf0, false}, // 0x29
+    {"SRA D", 2, 8, 0, "Z00C", 0xf0, false}, // 0x2a
+    {"SRA E", 2, 8, 0, "Z00C", 0xf0, false}, // 0x2b
+    {"SRA H", 2, 8, 0, "Z00C", 0xf0, false}, // 0x2c
+    {"SRA L", 2, 8, 0, "Z00C", 0xf0, false}, // 0x2d
+    {"SRA (HL)", 2, 16, 0, "Z00C", 0xf0, false}, // 0x2e
+    {"SRA A", 2, 8, 0, "Z00C", 0xf0, false}, // 0x2f
+    {"SWAP B", 2, 8, 0, "Z000", 0xf0, false}, // 0x30
+    {"SWAP C", 2, 8, 0, "Z000", 0xf0, false}, // 0x31
+    {"SWAP D", 2, 8, 0, "Z000", 0xf0, false}, // 0x32
+    {"SWAP E", 2, 8, 0, "Z000", 0xf0, false}, // 0x33
+    {"SWAP H", 2, 8, 0, "Z000", 0xf0, false}, // 0x34
+    {"SWAP L", 2, 8, 0, "Z000", 0xf0, false}, // 0x35
+    {"SWAP (HL)", 2, 16, 0, "Z000", 0xf0, false}, // 0x36
+    {"SWAP A", 2, 8, 0, "Z000", 0xf0, false}, // 0x37
+    {"SRL B", 2, 8, 0, "Z00C", 0xf0, false}, // 0x38
+    {"SRL C", 2, 8, 0, "Z00C", 0xf0, false}, // 0x39
+    {"SRL D", 2, 8, 0, "Z00C", 0xf0, false}, // 0x3a
+    {"SRL E", 2, 8, 0, "Z00C", 0xf0, false}, // 0x3b
+    {"SRL H", 2, 8, 0, "Z00C", 0xf0, false}, // 0x3c
+    {"SRL L", 2, 8, 0, "Z00C", 0xf0, false}, // 0x3d
+    {"SRL (HL)", 2, 16, 0, "Z00C", 0xf0, false}, // 0x3e
+    {"SRL A", 2, 8, 0, "Z00C", 0xf0, false}, // 0x3f
+    {"BIT 0, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x40
+    {"BIT 0, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x41
+    {"BIT 0, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x42
+    {"BIT 0, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x43
+    {"BIT 0, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x44
+    {"BIT 0, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x45
+    {"BIT 0, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x46
+    {"BIT 0, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x47
+    {"BIT 1, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x48
+    {"BIT 1, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x49
+    {"BIT 1, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x4a
+    {"BIT 1, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x4b
+    {"BIT 1, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x4c
+    {"BIT 1, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x4d
+    {"BIT 1, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x4e
+    {"BIT 1, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x4f
+    {"BIT 2, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x50
+    {"BIT 2, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x51
+    {"BIT 2, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x52
+    {"BIT 2, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x53
+    {"BIT 2, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x54
+    {"BIT 2, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x55
+    {"BIT 2, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x56
+    {"BIT 2, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x57
+    {"BIT 3, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x58
+    {"BIT 3, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x59
+    {"BIT 3, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x5a
+    {"BIT 3, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x5b
+    {"BIT 3, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x5c
+    {"BIT 3, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x5d
+    {"BIT 3, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x5e
+    {"BIT 3, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x5f
+    {"BIT 4, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x60
+    {"BIT 4, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x61
+    {"BIT 4, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x62
+    {"BIT 4, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x63
+    {"BIT 4, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x64
+    {"BIT 4, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x65
+    {"BIT 4, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x66
+    {"BIT 4, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x67
+    {"BIT 5, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x68
+    {"BIT 5, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x69
+    {"BIT 5, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x6a
+    {"BIT 5, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x6b
+    {"BIT 5, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x6c
+    {"BIT 5, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x6d
+    {"BIT 5, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x6e
+    {"BIT 5, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x6f
+    {"BIT 6, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x70
+    {"BIT 6, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x71
+    {"BIT 6, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x72
+    {"BIT 6, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x73
+    {"BIT 6, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x74
+    {"BIT 6, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x75
+    {"BIT 6, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x76
+    {"BIT 6, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x77
+    {"BIT 7, B", 2, 8, 0, "Z01-", 0xe0, false}, // 0x78
+    {"BIT 7, C", 2, 8, 0, "Z01-", 0xe0, false}, // 0x79
+    {"BIT 7, D", 2, 8, 0, "Z01-", 0xe0, false}, // 0x7a
+    {"BIT 7, E", 2, 8, 0, "Z01-", 0xe0, false}, // 0x7b
+    {"BIT 7, H", 2, 8, 0, "Z01-", 0xe0, false}, // 0x7c
+    {"BIT 7, L", 2, 8, 0, "Z01-", 0xe0, false}, // 0x7d
+    {"BIT 7, (HL)", 2, 12, 0, "Z01-", 0xe0, false}, // 0x7e
+    {"BIT 7, A", 2, 8, 0, "Z01-", 0xe0, false}, // 0x7f
+    {"RES 0, B", 2, 8, 0, "----", 0x00, false}, // 0x80
+    {"RES 0, C", 2, 8, 0, "----", 0x00, false}, // 0x81
+    {"RES 0, D", 2, 8, 0, "----", 0x00, false}, // 0x82
+    {"RES 0, E", 2, 8, 0, "----", 0x00, false}, // 0x83
+    {"RES 0, H", 2, 8, 0, "----", 0x00, false}, // 0x84
+    {"RES 0, L", 2, 8, 0, "----", 0x00, false}, // 0x85
+    {"RES 0, (HL)", 2, 16, 0, "----", 0x00, false}, // 0x86
+    {"RES 0, A", 2, 8, 0, "----", 0x00, false}, // 0x87
+    {"RES 1, B", 2, 8, 0, "----", 0x00, false}, // 0x88
+    {"RES 1, C", 2, 8, 0, "----", 0x00, false}, // 0x89
+    {"RES 1, D", 2, 8, 0, "----", 0x00, false}, // 0x8a
+    {"RES 1, E", 2, 8, 0, "----", 0x00, false}, // 0x8b
+    {"RES 1, H", 2, 8, 0, "----", 0x00, false}, // 0x8c
+    {"RES 1, L", 2, 8, 0, "----", 0x00, false}, // 0x8d
+    {"RES 1, (HL)", 2, 16, 0, "----", 0x00, false}, // 0x8e
+    {"RES 1, A", 2, 8, 0, "----", 0x00, false}, // 0x8f
+    {"RES 2, B", 2, 8, 0, "----", 0x00, false}, // 0x90
+    {"RES 2, C", 2, 8, 0, "----", 0x00, false}, // 0x91
+    {"RES 2, D", 2, 8, 0, "----", 0x00, false}, // 0x92
+    {"RES 2, E", 2, 8, 0, "----", 0x00, false}, // 0x93
+    {"RES 2, H", 2, 8, 0, "----", 0x00, false}, // 0x94
+    {"RES 2, L", 2, 8, 0, "----", 0x00, false}, // 0x95
+    {"RES 2, (HL)", 2, 16, 0, "----", 0x00, false}, // 0x96
+    {"RES 2, A", 2, 8, 0, "----", 0x00, false}, // 0x97
+    {"RES 3, B", 2, 8, 0, "----", 0x00, false}, // 0x98
+    {"RES 3, C", 2, 8, 0, "----", 0x00, false}, // 0x99
+    {"RES 3, D", 2, 8, 0, "----", 0x00, false}, // 0x9a
+    {"RES 3, E", 2, 8, 0, "----", 0x00, false}, // 0x9b
+    {"RES 3, H", 2, 8, 0, "----", 0x00, false}, // 0x9c
+    {"RES 3, L", 2, 8, 0, "----", 0x00, false}, // 0x9d
+    {"RES 3, (HL)", 2, 16, 0, "----", 0x00, false}, // 0x9e
+    {"RES 3, A", 2, 8, 0, "----", 0x00, false}, // 0x9f
+    {"RES 4, B", 2, 8, 0, "----", 0x00, false}, // 0xa0
+    {"RES 4, C", 2, 8, 0, "----", 0x00, false}, // 0xa1
+    {"RES 4, D", 2, 8, 0, "----", 0x00, false}, // 0xa2
+    {"RES 4, E", 2, 8, 0, "----", 0x00, false}, // 0xa3
+    {"RES 4, H", 2, 8, 0, "----", 0x00, false}, // 0xa4
+    {"RES 4, L", 2, 8, 0, "----", 0x00, false}, // 0xa5
+    {"RES 4, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xa6
+    {"RES 4, A", 2, 8, 0, "----", 0x00, false}, // 0xa7
+    {"RES 5, B", 2, 8, 0, "----", 0x00, false}, // 0xa8
+    {"RES 5, C", 2, 8, 0, "----", 0x00, false}, // 0xa9
+    {"RES 5, D", 2, 8, 0, "----", 0x00, false}, // 0xaa
+    {"RES 5, E", 2, 8, 0, "----", 0x00, false}, // 0xab
+    {"RES 5, H", 2, 8, 0, "----", 0x00, false}, // 0xac
+    {"RES 5, L", 2, 8, 0, "----", 0x00, false}, // 0xad
+    {"RES 5, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xae
+    {"RES 5, A", 2, 8, 0, "----", 0x00, false}, // 0xaf
+    {"RES 6, B", 2, 8, 0, "----", 0x00, false}, // 0xb0
+    {"RES 6, C", 2, 8, 0, "----", 0x00, false}, // 0xb1
+    {"RES 6, D", 2, 8, 0, "----", 0x00, false}, // 0xb2
+    {"RES 6, E", 2, 8, 0, "----", 0x00, false}, // 0xb3
+    {"RES 6, H", 2, 8, 0, "----", 0x00, false}, // 0xb4
+    {"RES 6, L", 2, 8, 0, "----", 0x00, false}, // 0xb5
+    {"RES 6, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xb6
+    {"RES 6, A", 2, 8, 0, "----", 0x00, false}, // 0xb7
+    {"RES 7, B", 2, 8, 0, "----", 0x00, false}, // 0xb8
+    {"RES 7, C", 2, 8, 0, "----", 0x00, false}, // 0xb9
+    {"RES 7, D", 2, 8, 0, "----", 0x00, false}, // 0xba
+    {"RES 7, E", 2, 8, 0, "----", 0x00, false}, // 0xbb
+    {"RES 7, H", 2, 8, 0, "----", 0x00, false}, // 0xbc
+    {"RES 7, L", 2, 8, 0, "----", 0x00, false}, // 0xbd
+    {"RES 7, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xbe
+    {"RES 7, A", 2, 8, 0, "----", 0x00, false}, // 0xbf
+    {"SET 0, B", 2, 8, 0, "----", 0x00, false}, // 0xc0
+    {"SET 0, C", 2, 8, 0, "----", 0x00, false}, // 0xc1
+    {"SET 0, D", 2, 8, 0, "----", 0x00, false}, // 0xc2
+    {"SET 0, E", 2, 8, 0, "----", 0x00, false}, // 0xc3
+    {"SET 0, H", 2, 8, 0, "----", 0x00, false}, // 0xc4
+    {"SET 0, L", 2, 8, 0, "----", 0x00, false}, // 0xc5
+    {"SET 0, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xc6
+    {"SET 0, A", 2, 8, 0, "----", 0x00, false}, // 0xc7
+    {"SET 1, B", 2, 8, 0, "----", 0x00, false}, // 0xc8
+    {"SET 1, C", 2, 8, 0, "----", 0x00, false}, // 0xc9
+    {"SET 1, D", 2, 8, 0, "----", 0x00, false}, // 0xca
+    {"SET 1, E", 2, 8, 0, "----", 0x00, false}, // 0xcb
+    {"SET 1, H", 2, 8, 0, "----", 0x00, false}, // 0xcc
+    {"SET 1, L", 2, 8, 0, "----", 0x00, false}, // 0xcd
+    {"SET 1, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xce
+    {"SET 1, A", 2, 8, 0, "----", 0x00, false}, // 0xcf
+    {"SET 2, B", 2, 8, 0, "----", 0x00, false}, // 0xd0
+    {"SET 2, C", 2, 8, 0, "----", 0x00, false}, // 0xd1
+    {"SET 2, D", 2, 8, 0, "----", 0x00, false}, // 0xd2
+    {"SET 2, E", 2, 8, 0, "----", 0x00, false}, // 0xd3
+    {"SET 2, H", 2, 8, 0, "----", 0x00, false}, // 0xd4
+    {"SET 2, L", 2, 8, 0, "----", 0x00, false}, // 0xd5
+    {"SET 2, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xd6
+    {"SET 2, A", 2, 8, 0, "----", 0x00, false}, // 0xd7
+    {"SET 3, B", 2, 8, 0, "----", 0x00, false}, // 0xd8
+    {"SET 3, C", 2, 8, 0, "----", 0x00, false}, // 0xd9
+    {"SET 3, D", 2, 8, 0, "----", 0x00, false}, // 0xda
+    {"SET 3, E", 2, 8, 0, "----", 0x00, false}, // 0xdb
+    {"SET 3, H", 2, 8, 0, "----", 0x00, false}, // 0xdc
+    {"SET 3, L", 2, 8, 0, "----", 0x00, false}, // 0xdd
+    {"SET 3, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xde
+    {"SET 3, A", 2, 8, 0, "----", 0x00, false}, // 0xdf
+    {"SET 4, B", 2, 8, 0, "----", 0x00, false}, // 0xe0
+    {"SET 4, C", 2, 8, 0, "----", 0x00, false}, // 0xe1
+    {"SET 4, D", 2, 8, 0, "----", 0x00, false}, // 0xe2
+    {"SET 4, E", 2, 8, 0, "----", 0x00, false}, // 0xe3
+    {"SET 4, H", 2, 8, 0, "----", 0x00, false}, // 0xe4
+    {"SET 4, L", 2, 8, 0, "----", 0x00, false}, // 0xe5
+    {"SET 4, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xe6
+    {"SET 4, A", 2, 8, 0, "----", 0x00, false}, // 0xe7
+    {"SET 5, B", 2, 8, 0, "----", 0x00, false}, // 0xe8
+    {"SET 5, C", 2, 8, 0, "----", 0x00, false}, // 0xe9
+    {"SET 5, D", 2, 8, 0, "----", 0x00, false}, // 0xea
+    {"SET 5, E", 2, 8, 0, "----", 0x00, false}, // 0xeb
+    {"SET 5, H", 2, 8, 0, "----", 0x00, false}, // 0xec
+    {"SET 5, L", 2, 8, 0, "----", 0x00, false}, // 0xed
+    {"SET 5, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xee
+    {"SET 5, A", 2, 8, 0, "----", 0x00, false}, // 0xef
+    {"SET 6, B", 2, 8, 0, "----", 0x00, false}, // 0xf0
+    {"SET 6, C", 2, 8, 0, "----", 0x00, false}, // 0xf1
+    {"SET 6, D", 2, 8, 0, "----", 0x00, false}, // 0xf2
+    {"SET 6, E", 2, 8, 0, "----", 0x00, false}, // 0xf3
+    {"SET 6, H", 2, 8, 0, "----", 0x00, false}, // 0xf4
+    {"SET 6, L", 2, 8, 0, "----", 0x00, false}, // 0xf5
+    {"SET 6, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xf6
+    {"SET 6, A", 2, 8, 0, "----", 0x00, false}, // 0xf7
+    {"SET 7, B", 2, 8, 0, "----", 0x00, false}, // 0xf8
+    {"SET 7, C", 2, 8, 0, "----", 0x00, false}, // 0xf9
+    {"SET 7, D", 2, 8, 0, "----", 0x00, false}, // 0xfa
+    {"SET 7, E", 2, 8, 0, "----", 0x00, false}, // 0xfb
+    {"SET 7, H", 2, 8, 0, "----", 0x00, false}, // 0xfc
+    {"SET 7, L", 2, 8, 0, "----", 0x00, false}, // 0xfd
+    {"SET 7, (HL)", 2, 16, 0, "----", 0x00, false}, // 0xfe
+    {"SET 7, A", 2, 8, 0, "----", 0x00, false}, // 0xff
+};
+
+// computed goto targets for the cpu's opcode dispatch, in opcode order
+#define OPCODE_LABELS { \
+    &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07, \
+    &&op_0x08, &&op_0x09, &&op_0x0a, &&op_0x0b, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f, \
+    &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17, \
+    &&op_0x18, &&op_0x19, &&op_0x1a, &&op_0x1b, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f, \
+    &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27, \
+    &&op_0x28, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_0x2f, \
+    &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37, \
+    &&op_0x38, &&op_0x39, &&op_0x3a, &&op_0x3b, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f, \
+    &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47, \
+    &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f, \
+    &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57, \
+    &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f, \
+    &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67, \
+    &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f, \
+    &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77, \
+    &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f, \
+    &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87, \
+    &&op_0x88, &&op_0x89, &&op_0x8a, &&op_0x8b, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_0x8f, \
+    &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97, \
+    &&op_0x98, &&op_0x99, &&op_0x9a, &&op_0x9b, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f, \
+    &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7, \
+    &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_0xab, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf, \
+    &&op_0xb0, &&op_0xb1, &&op_0xb2, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7, \
+    &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf, \
+    &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_0xc3, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_0xc7, \
+    &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf, \
+    &&op_0xd0, &&op_0xd1, &&op_0xd2, &&op_illegal, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_0xd7, \
+    &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_illegal, &&op_0xdc, &&op_illegal, &&op_0xde, &&op_0xdf, \
+    &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_illegal, &&op_illegal, &&op_0xe5, &&op_0xe6, &&op_0xe7, \
+    &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_illegal, &&op_illegal, &&op_illegal, &&op_0xee, &&op_0xef, \
+    &&op_0xf0, &&op_0xf1, &&op_0xf2, &&op_0xf3, &&op_illegal, &&op_0xf5, &&op_0xf6, &&op_0xf7, \
+    &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_0xfb, &&op_illegal, &&op_illegal, &&op_0xfe, &&op_0xff \
+}
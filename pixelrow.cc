@@ -0,0 +1,128 @@
+#include <cstring>
+
+#include "pixelrow.hh"
+
+#ifdef PIXEL_SIMD_SUPPORTED
+#include <immintrin.h>
+#endif
+
+static void expandRowsScalar(const uint8_t *const *rows, int rowCount, const uint32_t *palette, void *out){
+    uint8_t *pixels = (uint8_t *) out;
+    for(int row = 0; row < rowCount; row++){
+        for(int x = 0; x < ROW_PIXELS; x++){
+            memcpy(pixels, &palette[rows[row][x]], 4);
+            pixels += 4;
+        }
+    }
+}
+
+#ifdef PIXEL_SIMD_SUPPORTED
+// no byte shuffle in SSE2, so each pixel is picked with the two bits of its index as masks:
+// bit 0 chooses within palette[0..1] and palette[2..3], bit 1 between the two.
+// SSE2 is only a given on x86_64, a 32 bit build picks this kernel after checking for it
+__attribute__((target("sse2")))
+static void expandRowsSSE2(const uint8_t *const *rows, int rowCount, const uint32_t *palette, void *out){
+    __m128i zero = _mm_setzero_si128();
+    __m128i bit0 = _mm_set1_epi32(1);
+    __m128i bit1 = _mm_set1_epi32(2);
+    __m128i colour0 = _mm_set1_epi32(palette[0]);
+    __m128i colour2 = _mm_set1_epi32(palette[2]);
+    __m128i diffLow = _mm_set1_epi32(palette[0] ^ palette[1]);
+    __m128i diffHigh = _mm_set1_epi32(palette[2] ^ palette[3]);
+
+    __m128i *pixels = (__m128i *) out;
+    for(int row = 0; row < rowCount; row++){
+        __m128i indices = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) rows[row]), zero);
+        __m128i halves[2] = {_mm_unpacklo_epi16(indices, zero), _mm_unpackhi_epi16(indices, zero)};
+
+        for(int half = 0; half < 2; half++){
+            __m128i low = _mm_cmpeq_epi32(_mm_and_si128(halves[half], bit0), bit0);
+            __m128i high = _mm_cmpeq_epi32(_mm_and_si128(halves[half], bit1), bit1);
+            __m128i lowPair = _mm_xor_si128(colour0, _mm_and_si128(diffLow, low));
+            __m128i highPair = _mm_xor_si128(colour2, _mm_and_si128(diffHigh, low));
+            _mm_storeu_si128(pixels++, _mm_xor_si128(lowPair, _mm_and_si128(_mm_xor_si128(lowPair, highPair), high)));
+        }
+    }
+}
+
+// the palette is 16 bytes, so pshufb can index it directly: byte b of pixel i is palette byte index * 4 + b
+__attribute__((target("ssse3")))
+static void expandRowsSSSE3(const uint8_t *const *rows, int rowCount, const uint32_t *palette, void *out){
+    __m128i table = _mm_loadu_si128((const __m128i *) palette);
+    __m128i spreadLo = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    __m128i spreadHi = _mm_setr_epi8(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+    __m128i byteInPixel = _mm_setr_epi8(0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3);
+
+    __m128i *pixels = (__m128i *) out;
+    for(int row = 0; row < rowCount; row++){
+        __m128i indices = _mm_loadl_epi64((const __m128i *) rows[row]);
+        // indices are at most 3, so shifting 16 bit lanes never carries between bytes
+        __m128i lo = _mm_add_epi8(_mm_slli_epi16(_mm_shuffle_epi8(indices, spreadLo), 2), byteInPixel);
+        __m128i hi = _mm_add_epi8(_mm_slli_epi16(_mm_shuffle_epi8(indices, spreadHi), 2), byteInPixel);
+        _mm_storeu_si128(pixels++, _mm_shuffle_epi8(table, lo));
+        _mm_storeu_si128(pixels++, _mm_shuffle_epi8(table, hi));
+    }
+}
+
+// a whole row in one register, widened to one index per 32 bit lane and permuted straight out of the palette
+__attribute__((target("avx2")))
+static void expandRowsAVX2(const uint8_t *const *rows, int rowCount, const uint32_t *palette, void *out){
+    __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) palette));
+
+    __m256i *pixels = (__m256i *) out;
+    for(int row = 0; row < rowCount; row++){
+        __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) rows[row]));
+        _mm256_storeu_si256(pixels++, _mm256_permutevar8x32_epi32(table, indices));
+    }
+}
+#endif
+
+bool pixelRowKernelSupported(int kernel){
+    switch(kernel){
+        case PIXEL_KERNEL_SCALAR:
+            return true;
+#ifdef PIXEL_SIMD_SUPPORTED
+        case PIXEL_KERNEL_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case PIXEL_KERNEL_SSSE3:
+            return __builtin_cpu_supports("ssse3");
+        case PIXEL_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+    }
+    return false;
+}
+
+// checked at runtime, the same binary runs on cpus without AVX2
+int bestPixelRowKernel(){
+    for(int kernel = NUM_PIXEL_KERNELS - 1; kernel > PIXEL_KERNEL_SCALAR; kernel--){
+        if(pixelRowKernelSupported(kernel)){
+            return kernel;
+        }
+    }
+    return PIXEL_KERNEL_SCALAR;
+}
+
+PixelRowKernel getPixelRowKernel(int kernel){
+    if(!pixelRowKernelSupported(kernel)){
+        return expandRowsScalar;
+    }
+
+    switch(kernel){
+#ifdef PIXEL_SIMD_SUPPORTED
+        case PIXEL_KERNEL_SSE2:
+            return expandRowsSSE2;
+        case PIXEL_KERNEL_SSSE3:
+            return expandRowsSSSE3;
+        case PIXEL_KERNEL_AVX2:
+            return expandRowsAVX2;
+#endif
+        default:
+            return expandRowsScalar;
+    }
+}
+
+const char *pixelRowKernelName(int kernel){
+    const char *names[NUM_PIXEL_KERNELS] = {"scalar", "sse2", "ssse3", "avx2"};
+    return kernel >= 0 && kernel < NUM_PIXEL_KERNELS ? names[kernel] : "unknown";
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <iostream>
+
+// the vector kernels are written with x86 intrinsics, everything else gets the scalar one
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXEL_SIMD_SUPPORTED
+#endif
+
+// pixels in a tile row
+#define ROW_PIXELS 8
+
+#define PIXEL_KERNEL_SCALAR 0
+#define PIXEL_KERNEL_SSE2 1
+#define PIXEL_KERNEL_SSSE3 2
+#define PIXEL_KERNEL_AVX2 3
+#define NUM_PIXEL_KERNELS 4
+
+/**
+ * @brief
+ * Writes rowCount tile rows of ROW_PIXELS colour indices each out as 32 bit
+ * pixels, back to back, looking each index up in a 4 entry palette. The PPU
+ * gathers the rows of a scanline and hands them over in one call so the
+ * kernel is picked once per line, not once per tile.
+ */
+typedef void (*PixelRowKernel)(const uint8_t *const *rows, int rowCount, const uint32_t *palette, void *out);
+
+PixelRowKernel getPixelRowKernel(int kernel);
+bool pixelRowKernelSupported(int kernel);
+int bestPixelRowKernel();
+const char *pixelRowKernelName(int kernel);
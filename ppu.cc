@@ -1,35 +1,134 @@
 #include <iostream>
+#include <cstring>
 
 #include "ppu.hh"
 
-PPU::PPU(Memory *memory, Interrupt *interrupt){
+// each scheme's 4 shades, lightest first
+static const Colour colourSchemes[NUM_COLOUR_SCHEMES][4] = {
+    {{255, 255, 255, 255}, {192, 192, 192, 255}, {96, 96, 96, 255}, {0, 0, 0, 255}},
+    {{155, 188, 15, 255}, {139, 172, 15, 255}, {48, 98, 48, 255}, {15, 56, 15, 255}},
+    {{196, 207, 161, 255}, {139, 149, 109, 255}, {77, 83, 60, 255}, {31, 31, 31, 255}},
+};
+
+static const char *colourSchemeNames[NUM_COLOUR_SCHEMES] = {"grey", "green", "pocket"};
+
+static const char *lcdFormatNames[NUM_LCD_FORMATS] = {"rgba", "shades", "packed"};
+
+// the 4 shades in each possible LCD_FORMAT_PACKED byte, leftmost first
+struct UnpackTable{
+    uint8_t shades[256][4];
+
+    constexpr UnpackTable() : shades(){
+        for(int packed = 0; packed < 256; packed++){
+            for(int i = 0; i < 4; i++){
+                shades[packed][i] = (packed >> (6 - 2 * i)) & 0x3;
+            }
+        }
+    }
+};
+
+static constexpr UnpackTable unpackTable;
+
+PPU::PPU(Memory *memory, Interrupt *interrupt, Scheduler *scheduler){
     this->memory = memory;
     this->interrupt = interrupt;
+    this->scheduler = scheduler;
     this->scanlineCycles = 0;
+    memory->watchVideo(&videoDirty);
+
+    memory->registerIO(LCD_CONTROL, nullptr, [this](uint16_t, uint8_t content){
+        this->memory->memory[LCD_CONTROL] = content;
+        lcdControlWritten();
+    });
+
+    // the mode and coincidence bits belong to the ppu
+    memory->registerIO(LCD_STATUS, nullptr, nullptr, 0x78);
+
+    // writing to LCD Y coord/current scanline resets it
+    memory->registerIO(LY, nullptr, [this](uint16_t, uint8_t){
+        this->memory->memory[LY] = 0;
+    });
+
+    // the palettes are only looked at again when they change
+    for(uint16_t paletteAddress = BGP; paletteAddress <= OBP1; paletteAddress++){
+        memory->registerIO(paletteAddress, nullptr, [this](uint16_t address, uint8_t content){
+            this->memory->memory[address] = content;
+            updatePalette(address);
+        });
+    }
 
-    resetScreen();
+    setColourScheme(COLOUR_SCHEME_GREY);
+    setPixelKernel(bestPixelRowKernel());
+    setLCDFormat(LCD_FORMAT_RGBA);
 }
 
-void PPU::step(uint16_t cycles){
-    scanlineCycles += cycles;
-    // first check if the lcd is enabled in the first place
-    
-    if(!isLCDEnabled()){
-        uint8_t currStatus = getStatus();
-        scanlineCycles = 0;
-        memory->memory[LY] = 0;
-        internalWindowLine = 0;
-        windowInLine = 0;
-
-        // setting mode to 0
-        currStatus &= ~1;
-        currStatus &= ~(1 << 1);
-        memory->writeByte(LCD_STATUS, currStatus);
-        return;
+PPU::~PPU(){
+    memory->unwatchVideo(&videoDirty);
+    delete[] lcd;
+    delete[] shadeLcd;
+    delete[] packedLcd;
+}
+
+// pick up the lcd state the ppu powers on with
+void PPU::start(){
+    lcdOn = isLCDEnabled();
+    if(lcdOn){
+        modeStart = scheduler->now;
+        scheduleTransition();
+    }
+    else{
+        lcdOff();
     }
+}
 
-    
+/**
+ * @brief
+ * The current mode has run its course, move on to the next one. Fires on the
+ * first instruction boundary at or past the deadline, so the cycles it went
+ * over by carry into the next mode the same as stepping the ppu after every
+ * instruction would.
+ */
+void PPU::transition(){
+    scanlineCycles = scheduler->now - modeStart;
     setStatus();
+    modeStart = scheduler->now - scanlineCycles;
+    scheduleTransition();
+}
+
+void PPU::scheduleTransition(){
+    int modeCycles[4] = {HBLANK_CYCLES, SCANLINE_CYCLES, OAM_CYCLES, DRAWING_CYCLES};
+    scheduler->schedule(EVENT_PPU, modeStart + modeCycles[getStatus() & 0x03]);
+}
+
+/**
+ * @brief
+ * The cpu wrote LCDC. Switching the lcd on starts HBLANK from the writing
+ * instruction, switching it off stops the ppu.
+ */
+void PPU::lcdControlWritten(){
+    if(isLCDEnabled() && !lcdOn){
+        lcdOn = true;
+        modeStart = scheduler->now;
+        scheduleTransition();
+    }
+    else if(!isLCDEnabled() && lcdOn){
+        lcdOn = false;
+        scheduler->cancel(EVENT_PPU);
+        lcdOff();
+    }
+}
+
+void PPU::lcdOff(){
+    uint8_t currStatus = getStatus();
+    scanlineCycles = 0;
+    memory->memory[LY] = 0;
+    internalWindowLine = 0;
+    windowInLine = 0;
+
+    // setting mode to 0
+    currStatus &= ~1;
+    currStatus &= ~(1 << 1);
+    memory->memory[LCD_STATUS] = currStatus;
 }
 
 void PPU::setStatus(){
@@ -39,17 +138,17 @@ void PPU::setStatus(){
     // change the ppu status bits to the correct mode
     switch (ppuMode){
     case 2: // OAM Mode
-        if(scanlineCycles >= 80){
+        if(scanlineCycles >= OAM_CYCLES){
             // switch to mode 3
-            scanlineCycles -= 80;
+            scanlineCycles -= OAM_CYCLES;
             status |= 1;
             status |= (1<<1);
         }
         break;
     case 3: // Drawing mode
-        if(scanlineCycles >= 172){
+        if(scanlineCycles >= DRAWING_CYCLES){
             // switch to mode 0
-            scanlineCycles -= 172;
+            scanlineCycles -= DRAWING_CYCLES;
             status &= ~1;
             status &= ~(1 << 1);
             bool requestInterrupt = status & (1 << 3);
@@ -63,8 +162,8 @@ void PPU::setStatus(){
         }
         break;
     case 0: // HBLANK   
-        if(scanlineCycles >= 204){
-            scanlineCycles -= 204;  
+        if(scanlineCycles >= HBLANK_CYCLES){
+            scanlineCycles -= HBLANK_CYCLES;  
             
             // increment LY location
             incLine();
@@ -108,8 +207,8 @@ void PPU::setStatus(){
         }
         break;
     case 1: // VBLANK
-        if(scanlineCycles >= 456){
-            scanlineCycles -= 456;
+        if(scanlineCycles >= SCANLINE_CYCLES){
+            scanlineCycles -= SCANLINE_CYCLES;
             // go to next scanline
             incLine();
 
@@ -136,17 +235,26 @@ void PPU::setStatus(){
                 status |= (1<<1);
 
                 // this resets the value regardless
-                memory->writeByte(LY, 0);
+                memory->memory[LY] = 0;
             }
         }
         break;
     }
 
-    memory->writeByte(LCD_STATUS, status);
+    // straight into memory, a STAT write through writeByte is the cpu's
+    memory->memory[LCD_STATUS] = status;
 }
 
 void PPU::renderScanline(){
-    uint8_t lcdControlRegister = memory->readByte(LCD_CONTROL);
+    // the ppu has its own bus, it reads vram, oam and its registers straight
+    // out of memory so an OAM DMA locking the cpu out doesn't affect it
+    uint8_t lcdControlRegister = memory->memory[LCD_CONTROL];
+
+    // only the 144 visible lines are ever drawn
+    uint8_t line = getCurrLine();
+    if(line >= 144){
+        return;
+    }
     
     bool spriteDisplayEnable = lcdControlRegister & (1 << 1);
     bool bgDisplayEnable = lcdControlRegister & 1;
@@ -159,7 +267,16 @@ void PPU::renderScanline(){
     // }
 
     // we want to keep track of colour values from the background so that we can display sprites accurately
-    int scanLine[160] = {0};
+    uint8_t scanLine[160] = {0};
+
+    decodeTiles();
+
+    lcdLine = lcd ? lcd[line] : nullptr;
+    shadeLine = shadeLcd ? shadeLcd[line] : lineShades;
+    if(packedLcd){
+        // anything left undrawn keeps what was there last frame
+        unpackLine(packedLcd[line], lineShades);
+    }
 
     if(bgDisplayEnable){
         // draw background and window tiles
@@ -178,94 +295,82 @@ void PPU::renderScanline(){
         // draw sprite
         drawSprite(scanLine);
     }
+
+    if(packedLcd){
+        packLine(lineShades, packedLcd[line]);
+    }
 }
 
-void PPU::drawBackground(int *scanLine){
-    uint8_t lcdControlRegister = memory->readByte(LCD_CONTROL);
+void PPU::drawBackground(uint8_t *scanLine){
+    uint8_t lcdControlRegister = memory->memory[LCD_CONTROL];
 
     // 0 = 0x8800-0x97FF and the identity number will be signed, 1 = 0x8000-0x8FFF
     bool bgWindowTileSelect = lcdControlRegister & (1 << 4);
     // 0 = 0x9800-0x9bff, 1 = 0x9C00-0x9FFF
     bool bgTileMapSelect = lcdControlRegister & (1 << 3);
 
-    uint8_t scrollX = memory->readByte(SCROLL_X);
-    uint8_t scrollY = memory->readByte(SCROLL_Y);
+    uint8_t scrollX = memory->memory[SCROLL_X];
+    uint8_t scrollY = memory->memory[SCROLL_Y];
 
-    uint16_t backgroundLoc = 0x9800;
-    uint16_t tileDataLoc = 0x8800;
+    uint8_t line = getCurrLine();
+    if(line >= 144){
+        return;
+    }
 
+    uint16_t backgroundLoc = 0x9800;
     if(bgTileMapSelect){
         backgroundLoc = 0x9C00;
     }
 
-    if(bgWindowTileSelect){
-        // tile identity number will also be unsigned
-        tileDataLoc = 0x8000;
-    }
-
+    // the background wraps around at 256 pixels both ways
+    uint8_t backgroundY = line + scrollY;
     // represents which row of tiles in the background map
-    uint16_t yBackgroundLocOffset = (((getCurrLine() + scrollY) % 256)/8) * 32;
-
-    for(int i = 0; i < 160; i++){
-        uint8_t xBackgroundLocOffset = ((scrollX + i) & 0xFF)/8;
-
-        uint16_t tileAddress = backgroundLoc + yBackgroundLocOffset + xBackgroundLocOffset;
-        
-        uint16_t tileDataAddress = tileDataLoc;
-        if(bgWindowTileSelect){
-            uint8_t tileIndentifier = memory->readByte(tileAddress);
-            tileDataAddress += (tileIndentifier * 16);
+    const uint8_t *tileMapRow = memory->memory + backgroundLoc + (backgroundY / 8) * 32;
+    int pixelY = backgroundY % 8;
+
+    // SCX only lines the first tile up partway in, every tile after it starts on a multiple of 8
+    int fineX = scrollX % 8;
+    int i = 0;
+    if(fineX){
+        const uint8_t *row = decodedTiles[tileIndex(tileMapRow[scrollX / 8], bgWindowTileSelect)][pixelY];
+        for(; i < ROW_PIXELS - fineX; i++){
+            putPixel(i, 0, row[fineX + i]);
+            // we want to get the colour value before the palette for sprite display
+            scanLine[i] = row[fineX + i];
         }
-        else{
-            int8_t tileIndentifier = (int8_t) memory->readByte(tileAddress);
-            tileDataAddress += (tileIndentifier + 128) * 16;
-        }
-
-        // get exact pixel data
-        uint16_t pixelY = (((getCurrLine() + scrollY)) % 8) * 2;
-
-        uint16_t pixelX = (scrollX + i) & 0xFF;
-
-        uint8_t loByte = memory->readByte(tileDataAddress + pixelY);
-        uint8_t hiByte = memory->readByte(tileDataAddress + pixelY + 1);
-
-        int horizontalOffset = 7 - (pixelX%8);
-
-        uint8_t colourBitLo = (loByte >> horizontalOffset) & 1;
-        uint8_t colourBitHi = (hiByte >> horizontalOffset) & 1;
-
-        if(getCurrLine() >= 0 && getCurrLine() < 144 && i >= 0 && i < 160){
-            lcd[getCurrLine()][i] = getColour(colourBitHi, colourBitLo, BGP);
-
-            // if((getCurrLine() + scrollY)%8 == 7){
-            //     lcd[getCurrLine()][i] = {0,67,0,255};
-            // }
+    }
 
-            // if(getCurrLine() == 127){
-            //     lcd[getCurrLine()][i] = {255, 99, 71, 255};
-            // }
-            // if(getCurrLine() == 128){
-            //     lcd[getCurrLine()][0] = {67, 255, 71, 255};
-            // }
-            // if(getCurrLine() == 129){
-            //     lcd[getCurrLine()][0] = {67, 90, 255, 255};
-            // }            
-            // we want to get the colour value before the palette for sprite display 
-            scanLine[i] = (colourBitHi << 1) | (colourBitLo);
+    const uint8_t *rows[160 / ROW_PIXELS] = {nullptr};
+    int rowCount = 0;
+    for(; i + ROW_PIXELS <= 160; i += ROW_PIXELS){
+        uint8_t backgroundX = scrollX + i;
+        rows[rowCount] = decodedTiles[tileIndex(tileMapRow[backgroundX / 8], bgWindowTileSelect)][pixelY];
+        memcpy(scanLine + i, rows[rowCount], ROW_PIXELS);
+        rowCount++;
+    }
+    putRows(rows, rowCount, 0, i - rowCount * ROW_PIXELS);
+
+    // and the last tile is cut off by the edge of the screen
+    if(i < 160){
+        uint8_t backgroundX = scrollX + i;
+        const uint8_t *row = decodedTiles[tileIndex(tileMapRow[backgroundX / 8], bgWindowTileSelect)][pixelY];
+        for(int x = 0; i < 160; i++, x++){
+            putPixel(i, 0, row[x]);
+            scanLine[i] = row[x];
         }
     }
 }
 
-void PPU::drawWindow(int *scanLine){
-    uint8_t lcdControlRegister = memory->readByte(LCD_CONTROL);
+void PPU::drawWindow(uint8_t *scanLine){
+    uint8_t lcdControlRegister = memory->memory[LCD_CONTROL];
 
     // 0 = 0x9800-0x9BFF, 1 = 0x9C00-0x9FFF
     bool windowTileMapSelect = lcdControlRegister & (1 << 6);
     // 0 = 0x8800-0x97FF and the identity number will be signed, 1 = 0x8000-0x8FFF
     bool bgWindowTileSelect = lcdControlRegister & (1 << 4);
 
-    uint8_t windowX = memory->readByte(WINDOW_X);
-    uint8_t windowY = memory->readByte(WINDOW_Y);
+    uint8_t windowX = memory->memory[WINDOW_X];
+    uint8_t windowY = memory->memory[WINDOW_Y];
 
     // do not fetch window if we haven't reached window y value yet
     if(getCurrLine() < windowY){
@@ -280,65 +385,78 @@ void PPU::drawWindow(int *scanLine){
         return;
     }
 
+    uint8_t line = getCurrLine();
+    if(line >= 144){
+        return;
+    }
+
     windowX -= 7;
 
     uint16_t backgroundLoc = 0x9800;
-    uint16_t tileDataLoc = 0x8800;
-
     if(windowTileMapSelect){
         backgroundLoc = 0x9C00;
     }
 
-    if(bgWindowTileSelect){
-        // tile identity number will also be unsigned
-        tileDataLoc = 0x8000;
-    }
-
     // represents which row of tiles in the background map
-    uint16_t yBackgroundLocOffset = (internalWindowLine/8) * 32;
-
-    for(int i = 0; i < 160; i++){
-        if(i < windowX){
-            continue;
-        }
-
-        uint16_t xBackgroundLocOffset = (i - windowX)/8;
-
-        uint16_t tileAddress = backgroundLoc + yBackgroundLocOffset + xBackgroundLocOffset;
-
-        int tileIndentifier = bgWindowTileSelect ? (uint8_t) memory->readByte(tileAddress) : (int8_t) memory->readByte(tileAddress);
+    const uint8_t *tileMapRow = memory->memory + backgroundLoc + (internalWindowLine / 8) * 32;
+    int pixelY = internalWindowLine % 8;
+
+    // the window always starts on a tile boundary, only the last tile can be cut off
+    const uint8_t *rows[160 / ROW_PIXELS] = {nullptr};
+    int rowCount = 0;
+    int i = windowX;
+    for(; i + ROW_PIXELS <= 160; i += ROW_PIXELS){
+        rows[rowCount] = decodedTiles[tileIndex(tileMapRow[rowCount], bgWindowTileSelect)][pixelY];
+        memcpy(scanLine + i, rows[rowCount], ROW_PIXELS);
+        rowCount++;
+    }
+    putRows(rows, rowCount, 0, windowX);
 
-        uint16_t tileDataAddress = tileDataLoc;
-        if(bgWindowTileSelect){
-            tileDataAddress += (tileIndentifier * 16);
+    if(i < 160){
+        const uint8_t *row = decodedTiles[tileIndex(tileMapRow[rowCount], bgWindowTileSelect)][pixelY];
+        for(int x = 0; i < 160; i++, x++){
+            putPixel(i, 0, row[x]);
+            scanLine[i] = row[x];
         }
-        else{
-            tileDataAddress += (tileIndentifier + 128) * 16;
-        }
-
-        // get exact pixel data
-        uint16_t pixelY = ((internalWindowLine) % 8) * 2;
-
-        uint16_t pixelX = i - windowX;
-
-        uint8_t loByte = memory->readByte(tileDataAddress + pixelY);
-        uint8_t hiByte = memory->readByte(tileDataAddress + pixelY + 1);
+    }
+}
 
-        int horizontalOffset = 7 - (pixelX%8);
+// palette lookups for whole tile rows at once, through whichever kernel this cpu does best
+void PPU::expandRows(const uint8_t *const *rows, int rowCount, const Colour *colours, Colour *out){
+    uint32_t palette[4];
+    memcpy(palette, colours, sizeof(palette));
+    pixelRowKernel(rows, rowCount, palette, out);
+}
 
-        uint8_t colourBitLo = (loByte >> horizontalOffset) &1;
-        uint8_t colourBitHi = (hiByte >> horizontalOffset) & 1;
+// whole tile rows through a palette into the line being drawn, starting at x
+void PPU::putRows(const uint8_t *const *rows, int rowCount, int palette, int x){
+    if(lcdLine){
+        expandRows(rows, rowCount, palettes[palette], lcdLine + x);
+        return;
+    }
 
-        if(getCurrLine() >= 0 && getCurrLine() < 144 && i >= 0 && i < 160 && windowX <= i){
-            lcd[getCurrLine()][i] = getColour(colourBitHi, colourBitLo, BGP);
-            scanLine[i] = (colourBitHi << 1) | (colourBitLo);
-            windowInLine = true;
-        }
+    // all 8 pixels of a row at once, each byte is 0-3 so masking out one colour index per
+    // byte and multiplying by its shade can't carry into the next byte
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint8_t *rowShades = paletteShades[palette];
+    for(int row = 0; row < rowCount; row++){
+        uint64_t pixels;
+        memcpy(&pixels, rows[row], ROW_PIXELS);
+        uint64_t lo = pixels & ones;
+        uint64_t hi = (pixels >> 1) & ones;
+        uint64_t shades = ((hi ^ ones) & (lo ^ ones)) * rowShades[0] + ((hi ^ ones) & lo) * rowShades[1]
+                        + (hi & (lo ^ ones)) * rowShades[2] + (hi & lo) * rowShades[3];
+        memcpy(shadeLine + x + row * ROW_PIXELS, &shades, ROW_PIXELS);
     }
 }
 
-void PPU::drawSprite(int *scanLine){
-    uint8_t lcdControlRegister = memory->readByte(LCD_CONTROL);
+void PPU::setPixelKernel(int kernel){
+    pixelKernel = pixelRowKernelSupported(kernel) ? kernel : PIXEL_KERNEL_SCALAR;
+    pixelRowKernel = getPixelRowKernel(pixelKernel);
+}
+
+void PPU::drawSprite(uint8_t *scanLine){
+    uint8_t lcdControlRegister = memory->memory[LCD_CONTROL];
 
     // 0 = 8x8, 1 = 8x16
     bool spriteSize = lcdControlRegister & (1 << 2);
@@ -349,42 +467,38 @@ void PPU::drawSprite(int *scanLine){
         height = 16;
     }
 
-    /**
-     * each sprite has 4 bytes. we want to push them in backwards order
-     * so that we can pop each component efficiently in a stack manner
-     */
+    uint8_t line = getCurrLine();
+    if(line >= 144){
+        return;
+    }
 
-    std::vector<Sprite *> sprites;
+    // the first 10 sprites in oam that are on this line, reusing the same storage every line
+    lineSprites.clear();
     for(int i = 0; i < 40; i++){
-        // if each sprite is 4 bytes and there can only be 10, we stop at 40
-        if(sprites.size() == 10){
+        if(lineSprites.size() == 10){
             break;
         }
         uint16_t spriteAddress = 0xFE00 + (i * 4);
         
-        uint8_t ySpritePixel = memory->readByte(spriteAddress) - 16;
-        uint8_t xSpritePixel = memory->readByte(spriteAddress + 1) - 8;
-        uint8_t spriteTileNumber = memory->readByte(spriteAddress + 2);
-        uint8_t spriteAttributes = memory->readByte(spriteAddress + 3);
-
-        Sprite *currSprite = new Sprite(xSpritePixel, ySpritePixel, spriteTileNumber, spriteAttributes, spriteAddress);
+        uint8_t ySpritePixel = memory->memory[spriteAddress] - 16;
+        uint8_t xSpritePixel = memory->memory[spriteAddress + 1] - 8;
+        uint8_t spriteTileNumber = memory->memory[spriteAddress + 2];
+        uint8_t spriteAttributes = memory->memory[spriteAddress + 3];
 
         // does the sprite intersect with the scanline?
-        if(ySpritePixel <= getCurrLine() && (ySpritePixel + height) > getCurrLine()){
-            sprites.push_back(currSprite);
+        if(ySpritePixel <= line && (ySpritePixel + height) > line){
+            lineSprites.push_back(Sprite(xSpritePixel, ySpritePixel, spriteTileNumber, spriteAttributes, spriteAddress));
         }
     }
 
-    std::sort(sprites.begin(), sprites.end());
+    // drawn back to front so the sprite earliest in oam ends up on top
+    for(int s = lineSprites.size() - 1; s >= 0; s--){
+        Sprite &currSprite = lineSprites[s];
 
-    while(sprites.size() != 0){
-        Sprite *currSprite = sprites.back();
-        sprites.pop_back();
-
-        uint8_t ySpritePixel = currSprite->ySpritePixel;
-        uint8_t xSpritePixel = currSprite->xSpritePixel;
-        uint8_t spriteTileNumber = currSprite->spriteTileNumber;
-        uint8_t spriteAttributes = currSprite->spriteAttributes;
+        uint8_t ySpritePixel = currSprite.ySpritePixel;
+        uint8_t xSpritePixel = currSprite.xSpritePixel;
+        uint8_t spriteTileNumber = currSprite.spriteTileNumber;
+        uint8_t spriteAttributes = currSprite.spriteAttributes;
 
         if(height == 16){
             spriteTileNumber &= 0xFE;
@@ -394,49 +508,29 @@ void PPU::drawSprite(int *scanLine){
             uint8_t spritePriority = spriteAttributes & (1 << 7);
             bool yFlip = spriteAttributes & (1 << 6);
             bool xFlip = spriteAttributes & (1 << 5);
-            uint8_t paletteSelect = spriteAttributes & (1 << 4);
+            // OBP0 or OBP1, after BGP in palettes
+            int palette = 1 + ((spriteAttributes >> 4) & 1);
 
-            int verticalPos = getCurrLine() - ySpritePixel;
+            int verticalPos = line - ySpritePixel;
             if(yFlip){
-                verticalPos = height - (getCurrLine() - ySpritePixel) - 1;
+                verticalPos = height - (line - ySpritePixel) - 1;
             }
 
-            uint16_t spriteTileAddress = 0x8000 + (spriteTileNumber * 16) + (2 * verticalPos);
-
-            uint8_t spriteBitLo = memory->readByte(spriteTileAddress);
-            uint8_t spriteBitHi = memory->readByte(spriteTileAddress + 1);
+            // the bottom half of a tall sprite is the next tile
+            const uint8_t *row = decodedTiles[spriteTileNumber + verticalPos / 8][verticalPos % 8];
 
-            // go through the 8 horizontal pixels of the tile
             for(int i = 0; i < 8; i++){
-                uint8_t horizontalPos = i;
-                if(xFlip){
-                    horizontalPos = 7 - i;
+                uint16_t xPixelPos = xSpritePixel + i;
+                if(xPixelPos >= 160){
+                    break;
                 }
 
-                uint8_t colourBitLo = (spriteBitLo >> horizontalPos) & 1;
-                uint8_t colourBitHi = (spriteBitHi >> horizontalPos) & 1;
-
-                // tile pixels are organized in reverse order
-                uint16_t xPixelPos = 7 - i + xSpritePixel;
-                if(getCurrLine() >= 0 && getCurrLine() < 144 && xPixelPos >= 0 && xPixelPos < 160){
-                    //printf("colour being pushed: (%d, %d, %d, %d)\n", currColour.r, currColour.g, currColour.b, currColour.a);
-                    // either there is no background or window rendered or the sprite has priority
-                    SDL_Colour currColour;
-                    if(paletteSelect){
-                        currColour = getColour(colourBitHi, colourBitLo, OBP1);
-                    }
-                    else{
-                        currColour = getColour(colourBitHi, colourBitLo, OBP0);
-                    }
-
-                    // white pixel = transparent
-                    if ((colourBitHi << 1) | (colourBitLo)){
-                        // keep in mind that spritePriority = 0 means that sprite is prioritized
-                        if((scanLine[xPixelPos] == 0) || !spritePriority){
-                            lcd[getCurrLine()][xPixelPos] = currColour;
-                        }
-                    }
-                    
+                uint8_t colour = row[xFlip ? 7 - i : i];
+
+                // white pixel = transparent
+                // keep in mind that spritePriority = 0 means that sprite is prioritized
+                if(colour && (scanLine[xPixelPos] == 0 || !spritePriority)){
+                    putPixel(xPixelPos, palette, colour);
                 }
             }
         }
@@ -446,50 +540,204 @@ void PPU::drawSprite(int *scanLine){
 void PPU::resetScreen(){
     // default colour will be white
 
-    for(int i = 0; i < 144; i++){
-        for(int j = 0; j < 160; j++){
-            lcd[i][j] = {255, 255, 255, 0};
+    if(lcd){
+        for(int i = 0; i < 144; i++){
+            for(int j = 0; j < 160; j++){
+                lcd[i][j] = {255, 255, 255, 0};
+            }
         }
     }
-
+    if(shadeLcd){
+        memset(shadeLcd, 0, 144 * 160);
+    }
+    if(packedLcd){
+        memset(packedLcd, 0, 144 * PACKED_LINE_BYTES);
+    }
 }
 
-SDL_Color PPU::getColour(uint8_t pixelHi, uint8_t pixelLo, uint16_t paletteAddress){
-    uint8_t combinedColour = (pixelHi << 1) | (pixelLo);
-    uint8_t palette = memory->readByte(paletteAddress);
-    uint8_t colour = (palette >> (2 * combinedColour)) & 0x3;
+/**
+ * @brief
+ * Draw the frame from now on as one of the LCD_FORMAT_ formats. Only that
+ * format's buffer is kept, so the indexed formats take a quarter or a
+ * sixteenth of the memory and bandwidth of rgba. The frame starts over white.
+ */
+void PPU::setLCDFormat(int format){
+    if(format < 0 || format >= NUM_LCD_FORMATS){
+        format = LCD_FORMAT_RGBA;
+    }
 
-    SDL_Color res = {0, 0, 0, 255};
-    switch(colour){
-        case 0:
-            // white
-            res = {255, 255, 255, 255};
-            break;
-        case 1:
-            res = {192, 192, 192, 255};
+    delete[] lcd;
+    delete[] shadeLcd;
+    delete[] packedLcd;
+    lcd = nullptr;
+    shadeLcd = nullptr;
+    packedLcd = nullptr;
+
+    lcdFormat = format;
+    switch(format){
+        case LCD_FORMAT_SHADES:
+            shadeLcd = new uint8_t[144][160];
             break;
-        case 2:
-            res = {96, 96, 96, 255};
+        case LCD_FORMAT_PACKED:
+            packedLcd = new uint8_t[144][PACKED_LINE_BYTES];
             break;
         default:
-            // black
-            res = {0, 0, 0, 255};
+            lcd = new Colour[144][160];
             break;
     }
+    resetScreen();
+}
+
+// the frame as it is stored, for hashing or comparing without converting it
+const uint8_t *PPU::frameData(){
+    if(shadeLcd){
+        return &shadeLcd[0][0];
+    }
+    if(packedLcd){
+        return &packedLcd[0][0];
+    }
+    return (const uint8_t *) &lcd[0][0];
+}
+
+size_t PPU::frameSize(){
+    if(shadeLcd){
+        return 144 * 160;
+    }
+    if(packedLcd){
+        return 144 * PACKED_LINE_BYTES;
+    }
+    return 144 * 160 * sizeof(Colour);
+}
+
+/**
+ * @brief
+ * Write the frame out as rgba whatever format it was drawn in, pitch bytes
+ * apart per line. The shades go through the pixel kernel the same way tile
+ * rows go through a palette.
+ */
+void PPU::convertFrame(Colour *out, int pitch){
+    uint32_t palette[4];
+    memcpy(palette, shades, sizeof(palette));
+
+    for(int line = 0; line < 144; line++){
+        Colour *outLine = (Colour *) ((uint8_t *) out + line * pitch);
+        if(lcd){
+            memcpy(outLine, lcd[line], sizeof(lcd[line]));
+            continue;
+        }
+
+        uint8_t unpacked[160];
+        const uint8_t *frameShades = shadeLcd ? shadeLcd[line] : unpacked;
+        if(packedLcd){
+            unpackLine(packedLcd[line], unpacked);
+        }
+
+        const uint8_t *rows[160 / ROW_PIXELS];
+        for(int row = 0; row < 160 / ROW_PIXELS; row++){
+            rows[row] = frameShades + row * ROW_PIXELS;
+        }
+        pixelRowKernel(rows, 160 / ROW_PIXELS, palette, outLine);
+    }
+}
+
+void PPU::packLine(const uint8_t *shades, uint8_t *packed){
+    for(int i = 0; i < PACKED_LINE_BYTES; i++){
+        const uint8_t *pixels = shades + i * 4;
+        packed[i] = (pixels[0] << 6) | (pixels[1] << 4) | (pixels[2] << 2) | pixels[3];
+    }
+}
+
+void PPU::unpackLine(const uint8_t *packed, uint8_t *shades){
+    for(int i = 0; i < PACKED_LINE_BYTES; i++){
+        memcpy(shades + i * 4, unpackTable.shades[packed[i]], 4);
+    }
+}
+
+/**
+ * @brief
+ * Work out what each of the 4 colour indices looks like through a palette
+ * register. Each pair of bits in the register picks the shade for one index,
+ * index 0 in the lowest bits.
+ */
+void PPU::updatePalette(uint16_t paletteAddress){
+    uint8_t palette = memory->memory[paletteAddress];
+    for(int colour = 0; colour < 4; colour++){
+        paletteShades[paletteAddress - BGP][colour] = (palette >> (2 * colour)) & 0x3;
+        palettes[paletteAddress - BGP][colour] = shades[paletteShades[paletteAddress - BGP][colour]];
+    }
+}
+
+void PPU::setColourScheme(int scheme){
+    if(scheme < 0 || scheme >= NUM_COLOUR_SCHEMES){
+        scheme = COLOUR_SCHEME_GREY;
+    }
+    setShades(colourSchemes[scheme]);
+}
+
+// any 4 colours can stand in for the shades, the palettes are redone once here
+void PPU::setShades(const Colour *shades){
+    memcpy(this->shades, shades, sizeof(this->shades));
+    for(uint16_t paletteAddress = BGP; paletteAddress <= OBP1; paletteAddress++){
+        updatePalette(paletteAddress);
+    }
+}
 
-    return res;
+const char *PPU::lcdFormatName(int format){
+    if(format < 0 || format >= NUM_LCD_FORMATS){
+        return "unknown";
+    }
+    return lcdFormatNames[format];
+}
+
+const char *PPU::colourSchemeName(int scheme){
+    if(scheme < 0 || scheme >= NUM_COLOUR_SCHEMES){
+        return "unknown";
+    }
+    return colourSchemeNames[scheme];
+}
+
+/**
+ * @brief
+ * Bring the decoded copy of every tile the cpu changed since the last line
+ * up to date. Each row of a tile is stored as 8 colour indices, left to right.
+ */
+void PPU::decodeTiles(){
+    if(memory->videoGeneration == decodedGeneration){
+        return;
+    }
+    decodedGeneration = memory->videoGeneration;
+
+    for(int word = 0; word < TILE_COUNT / 64; word++){
+        uint64_t dirty = videoDirty.tiles[word];
+        videoDirty.tiles[word] = 0;
+
+        while(dirty){
+            int tile = word * 64 + __builtin_ctzll(dirty);
+            dirty &= dirty - 1;
+
+            const uint8_t *tileData = memory->memory + VRAM_START + tile * 16;
+            for(int row = 0; row < 8; row++){
+                uint8_t loByte = tileData[row * 2];
+                uint8_t hiByte = tileData[row * 2 + 1];
+                for(int x = 0; x < 8; x++){
+                    int horizontalOffset = 7 - x;
+                    decodedTiles[tile][row][x] = (((hiByte >> horizontalOffset) & 1) << 1) | ((loByte >> horizontalOffset) & 1);
+                }
+            }
+        }
+    }
 }
 
 uint8_t PPU::getStatus(){
-    return memory->readByte(LCD_STATUS);
+    return memory->memory[LCD_STATUS];
 }
 
 uint8_t PPU::getCurrLine(){
-    return memory->readByte(LY);
+    return memory->memory[LY];
 }
 
 void PPU::incLine(){
-    if (windowInLine && getCurrLine() >= memory->readByte(WINDOW_Y) && getCurrLine() < memory->readByte(WINDOW_Y) + 144){
+    if (windowInLine && getCurrLine() >= memory->memory[WINDOW_Y] && getCurrLine() < memory->memory[WINDOW_Y] + 144){
         internalWindowLine++;
     }
 
@@ -497,10 +745,10 @@ void PPU::incLine(){
 }
 
 bool PPU::checkCoincidence(){
-    return memory->readByte(LY) == memory->readByte(LYC);
+    return memory->memory[LY] == memory->memory[LYC];
 }
 
 bool PPU::isLCDEnabled(){
     // lcd enabled status is on the 7th bit
-    return memory->readByte(LCD_CONTROL) & (1 << 7);
+    return memory->memory[LCD_CONTROL] & (1 << 7);
 }
\ No newline at end of file
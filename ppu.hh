@@ -2,11 +2,13 @@
 
 #include <iostream>
 #include <vector>
-#include <SDL2/SDL.h>
+#include <algorithm>
 
 #include "memory.hh"
 #include "interrupt.hh"
+#include "scheduler.hh"
 #include "sprite.hh"
+#include "pixelrow.hh"
 
 #define LCD 1
 
@@ -22,22 +24,93 @@
 #define WINDOW_Y 0xFF4A
 #define WINDOW_X 0xFF4B
 
+// cycles each ppu mode lasts
+#define OAM_CYCLES 80
+#define DRAWING_CYCLES 172
+#define HBLANK_CYCLES 204
+#define SCANLINE_CYCLES 456
+
+// same layout as SDL_Color and an SDL_PIXELFORMAT_RGBA32 pixel, so the frontend uploads lcd
+// to its texture as is, but keeps the ppu free of SDL
+struct Colour{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+static_assert(sizeof(Colour) == 4, "the pixel kernels write colours as 32 bit pixels");
+
+// what the 4 dmg shades look like on screen
+#define COLOUR_SCHEME_GREY 0
+#define COLOUR_SCHEME_GREEN 1
+#define COLOUR_SCHEME_POCKET 2
+#define NUM_COLOUR_SCHEMES 3
+
+// what the frame is drawn as. rgba is ready for the screen, the other two only keep each
+// pixel's shade, 0 lightest to 3 darkest, a byte each or packed 4 to a byte
+#define LCD_FORMAT_RGBA 0
+#define LCD_FORMAT_SHADES 1
+#define LCD_FORMAT_PACKED 2
+#define NUM_LCD_FORMATS 3
+
+// bytes in a line of LCD_FORMAT_PACKED, the leftmost pixel is in the top 2 bits
+#define PACKED_LINE_BYTES 40
+
 class PPU{
     public:
-        SDL_Color lcd[144][160];
+        // the frame being drawn, kept for the life of the ppu and presented straight from here.
+        // only the buffer for lcdFormat is allocated, the others are nullptr
+        Colour (*lcd)[160] = nullptr;
+        uint8_t (*shadeLcd)[160] = nullptr;
+        uint8_t (*packedLcd)[PACKED_LINE_BYTES] = nullptr;
+        int lcdFormat = LCD_FORMAT_RGBA;
+        // every vram tile as [tile][row][pixel] colour indices, redone when the tile's dirty bit is set
+        uint8_t decodedTiles[TILE_COUNT][8][8];
+        // the ppu's own view of what changed in video memory, only the tile bits are used
+        VideoDirty videoDirty;
+        // memory->videoGeneration as of the last decodeTiles, nothing to do while it's the same
+        uint64_t decodedGeneration = 0;
         int scanlineCycles = 0;
+        // cycle the current mode started on, scanlineCycles is worked out from it when the mode ends
+        uint64_t modeStart = 0;
+        bool lcdOn = false;
         int internalWindowLine = 0;
         bool drawLCD = false;
         bool windowInLine = false;
+        // the shades the palette registers pick from, lightest first
+        Colour shades[4];
+        // BGP, OBP0 and OBP1 already run through shades, indexed by the register's offset from BGP.
+        // redone when one of them is written or the shades change, never per pixel
+        Colour palettes[3][4];
+        // the same palettes as shades, for the indexed formats
+        uint8_t paletteShades[3][4];
+        // which PIXEL_KERNEL_ turns tile rows into pixels, the best the cpu supports unless set otherwise
+        int pixelKernel = PIXEL_KERNEL_SCALAR;
 
-        PPU(Memory *memory, Interrupt *interrupt);
-        void step(uint16_t cycles);
+        PPU(Memory *memory, Interrupt *interrupt, Scheduler *scheduler);
+        ~PPU();
+        void start();
+        void transition();
+        void scheduleTransition();
+        void lcdControlWritten();
+        void lcdOff();
         void setStatus();
+        void setPixelKernel(int kernel);
+        void setColourScheme(int scheme);
+        void setShades(const Colour *shades);
+        void updatePalette(uint16_t paletteAddress);
+        void setLCDFormat(int format);
+        const uint8_t *frameData();
+        size_t frameSize();
+        void convertFrame(Colour *out, int pitch);
 
         void renderScanline();
-        void drawBackground(int *scanLine);
-        void drawWindow(int *scanLine);
-        void drawSprite(int *scanLine);
+        void drawBackground(uint8_t *scanLine);
+        void drawWindow(uint8_t *scanLine);
+        void drawSprite(uint8_t *scanLine);
+        void expandRows(const uint8_t *const *rows, int rowCount, const Colour *colours, Colour *out);
+        void putRows(const uint8_t *const *rows, int rowCount, int palette, int x);
         void resetScreen();
 
         void incLine();
@@ -47,10 +120,43 @@ class PPU{
         bool checkCoincidence();
         bool isLCDEnabled();
 
-        SDL_Color getColour(uint8_t pixelHi, uint8_t pixelLo, uint16_t paletteAddress);
+        static const char *colourSchemeName(int scheme);
+        static const char *lcdFormatName(int format);
+
+        void decodeTiles();
+
+        // tile map entries number tiles from 0x8000, or signed from 0x9000 with 0x8800 addressing
+        int tileIndex(uint8_t identifier, bool unsignedTiles){
+            return unsignedTiles ? identifier : 256 + (int8_t) identifier;
+        }
+
+        // colour index through one of palettes, into whichever format the line is being drawn in
+        void putPixel(int x, int palette, uint8_t colour){
+            if(lcdLine){
+                lcdLine[x] = palettes[palette][colour];
+            }
+            else{
+                shadeLine[x] = paletteShades[palette][colour];
+            }
+        }
         
 
     private:
         Memory *memory;
         Interrupt *interrupt;
+        Scheduler *scheduler;
+
+        PixelRowKernel pixelRowKernel;
+
+        // where the line being drawn goes, lcdLine in rgba and shadeLine otherwise.
+        // packed lines are unpacked into lineShades, drawn and packed back
+        Colour *lcdLine = nullptr;
+        uint8_t *shadeLine = nullptr;
+        uint8_t lineShades[160];
+
+        void packLine(const uint8_t *shades, uint8_t *packed);
+        void unpackLine(const uint8_t *packed, uint8_t *shades);
+
+        // sprites on the line being drawn
+        std::vector<Sprite> lineSprites;
 };
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "romimage.hh"
+#include "mbc.hh"
+
+std::mutex RomImage::registryLock;
+std::unordered_map<uint64_t, std::weak_ptr<RomImage>> RomImage::registry;
+
+// banks selected past the end of the mapping read as 0, same as past the end of the file
+static const uint8_t emptyBank[ROM_BANK_SIZE] = {0};
+
+// end of the cartridge header, past the global checksum
+#define ROM_HEADER_END 0x150
+
+static uint64_t fnv1a(const uint8_t *data, size_t size){
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < size; i++){
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief
+ * Map filename and hand back the shared image for its contents. A file that
+ * can't be opened gives an empty image, so the emulator still runs (on zeros)
+ * like it always has.
+ */
+std::shared_ptr<RomImage> RomImage::open(std::string filename){
+    std::shared_ptr<RomImage> image(new RomImage());
+    if(!image->map(filename)){
+        std::cout << "could not open file... :(" << std::endl;
+    }
+    // the header carries the title and checksums, hashing just that keeps opening
+    // an 8MB rom from faulting in every page. Matches are still compared in full
+    image->hash = fnv1a(image->data, std::min(image->size, (size_t) ROM_HEADER_END)) ^ image->size;
+
+    std::lock_guard<std::mutex> lock(registryLock);
+    std::shared_ptr<RomImage> shared = registry[image->hash].lock();
+    if(shared && shared->size == image->size && memcmp(shared->data, image->data, image->size) == 0){
+        // already loaded, the new mapping is dropped when image goes out of scope
+        return shared;
+    }
+
+    registry[image->hash] = image;
+    return image;
+}
+
+bool RomImage::map(std::string filename){
+    // reserve zeroed pages to cover the largest rom, then lay the file over the start of them
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    bool opened = fd >= 0 && fstat(fd, &info) == 0;
+    size = opened ? info.st_size : 0;
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    mappingSize = std::max((size_t) MAX_GAME_SIZE, (size + pageSize - 1) & ~(pageSize - 1));
+    void *reserved = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(reserved == MAP_FAILED){
+        std::cout << "could not reserve memory for the rom" << std::endl;
+        exit(1);
+    }
+    mapping = (uint8_t *) reserved;
+    data = mapping;
+
+    if(opened && size > 0 && mmap(mapping, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED){
+        opened = false;
+        size = 0;
+    }
+
+    if(fd >= 0){
+        close(fd);
+    }
+
+    while((size_t) bankCount * ROM_BANK_SIZE < size){
+        bankCount <<= 1;
+    }
+    return opened;
+}
+
+RomImage::~RomImage(){
+    if(mapping){
+        munmap(mapping, mappingSize);
+    }
+
+    std::lock_guard<std::mutex> lock(registryLock);
+    std::unordered_map<uint64_t, std::weak_ptr<RomImage>>::iterator found = registry.find(hash);
+    if(found != registry.end() && found->second.expired()){
+        registry.erase(found);
+    }
+}
+
+const uint8_t *RomImage::bank(int bankNumber){
+    size_t offset = (size_t) (bankNumber & (bankCount - 1)) * ROM_BANK_SIZE;
+    // only a file that isn't a power of two banks long has banks past its end
+    if(offset >= size || offset + ROM_BANK_SIZE > mappingSize){
+        return emptyBank;
+    }
+    return data + offset;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#define ROM_BANK_SIZE 0x4000
+
+/**
+ * @brief
+ * A rom file mapped read-only into memory. Images are keyed by a hash of
+ * their contents and shared between every cartridge in the process that
+ * loads the same rom, the last one to let go unmaps it.
+ *
+ * At least MAX_GAME_SIZE bytes are always readable, anything past the end of
+ * the file reads as 0. Bank numbers wrap at the size of the file like they do
+ * on a real cartridge, where the upper bank bits aren't wired to anything.
+ */
+class RomImage{
+    public:
+        const uint8_t *data = nullptr;
+        // size of the rom file
+        size_t size = 0;
+        uint64_t hash = 0;
+        // banks in the file rounded up to a power of two, bank numbers are masked with bankCount - 1
+        int bankCount = 2;
+
+        static std::shared_ptr<RomImage> open(std::string filename);
+        ~RomImage();
+
+        const uint8_t *bank(int bankNumber);
+
+    private:
+        uint8_t *mapping = nullptr;
+        size_t mappingSize = 0;
+
+        RomImage() = default;
+        bool map(std::string filename);
+
+        static std::mutex registryLock;
+        static std::unordered_map<uint64_t, std::weak_ptr<RomImage>> registry;
+};
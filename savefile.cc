@@ -0,0 +1,73 @@
+#include <iostream>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "savefile.hh"
+
+SaveFile::SaveFile(std::string filename, size_t size, int syncIntervalMs){
+    this->syncIntervalMs = syncIntervalMs;
+
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if(fd < 0 || fstat(fd, &info) != 0){
+        std::cout << "could not open save file " << filename << std::endl;
+        if(fd >= 0){
+            close(fd);
+        }
+        return;
+    }
+
+    // a new or short file is grown with zeros, a longer one keeps whatever is past the end
+    existingSize = info.st_size;
+    if(existingSize < size && ftruncate(fd, size) != 0){
+        std::cout << "could not grow save file " << filename << std::endl;
+        close(fd);
+        return;
+    }
+
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // the mapping keeps the file open
+    close(fd);
+    if(mapped == MAP_FAILED){
+        std::cout << "could not map save file " << filename << std::endl;
+        return;
+    }
+
+    this->data = (uint8_t *) mapped;
+    this->size = size;
+    syncThread = std::thread(&SaveFile::syncLoop, this);
+}
+
+SaveFile::~SaveFile(){
+    if(syncThread.joinable()){
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        syncThread.join();
+    }
+
+    if(data){
+        sync();
+        munmap(data, size);
+    }
+}
+
+// write back now if anything changed, blocks until it's on disk
+void SaveFile::sync(){
+    if(data && dirty.exchange(false, std::memory_order_acquire)){
+        msync(data, size, MS_SYNC);
+    }
+}
+
+void SaveFile::syncLoop(){
+    std::unique_lock<std::mutex> guard(lock);
+    while(!stopping){
+        wake.wait_for(guard, std::chrono::milliseconds(syncIntervalMs), [this]{ return stopping; });
+        sync();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// how often the background thread flushes a dirty save to disk
+#define SAVE_SYNC_INTERVAL_MS 1000
+
+/**
+ * @brief
+ * A battery save mapped shared onto its .sav file, so the cartridge's external
+ * ram lives in the file itself and writing it is only a store. Writers mark the
+ * save dirty and a background thread msyncs it at most once an interval, the
+ * emulation thread never waits on the disk. A crash loses at most one interval.
+ */
+class SaveFile{
+    public:
+        uint8_t *data = nullptr;
+        size_t size = 0;
+        // how much of the file was already there, 0 for a new save
+        size_t existingSize = 0;
+
+        SaveFile(std::string filename, size_t size, int syncIntervalMs);
+        ~SaveFile();
+
+        void markDirty(){
+            dirty.store(true, std::memory_order_release);
+        }
+
+        void sync();
+
+    private:
+        int syncIntervalMs;
+        std::atomic<bool> dirty{false};
+        bool stopping = false;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::thread syncThread;
+
+        void syncLoop();
+};
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <algorithm>
+
+#include "scheduler.hh"
+
+Scheduler::Scheduler(){
+    for(int i = 0; i < NUM_EVENTS; i++){
+        deadlines[i] = NO_EVENT;
+    }
+}
+
+// replaces whatever was pending for the event
+void Scheduler::schedule(int event, uint64_t deadline){
+    deadlines[event] = deadline;
+    findNextDeadline();
+}
+
+void Scheduler::cancel(int event){
+    deadlines[event] = NO_EVENT;
+    findNextDeadline();
+}
+
+/**
+ * @brief
+ * Takes the earliest event that is due by now off the table and returns it,
+ * -1 if nothing is due. The caller reschedules it if it repeats.
+ */
+int Scheduler::popDue(){
+    if(nextDeadline > now){
+        return -1;
+    }
+
+    int event = 0;
+    for(int i = 1; i < NUM_EVENTS; i++){
+        if(deadlines[i] < deadlines[event]){
+            event = i;
+        }
+    }
+
+    deadlines[event] = NO_EVENT;
+    findNextDeadline();
+    return event;
+}
+
+void Scheduler::findNextDeadline(){
+    nextDeadline = NO_EVENT;
+    for(int i = 0; i < NUM_EVENTS; i++){
+        nextDeadline = std::min(nextDeadline, deadlines[i]);
+    }
+}
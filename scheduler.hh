@@ -0,0 +1,38 @@
+#pragma once
+
+#include <iostream>
+#include <cstdint>
+
+// things outside the cpu that happen at a known cycle, lower numbers go first when they land together
+#define EVENT_TIMER 0
+#define EVENT_PPU 1
+#define EVENT_JOYPAD_POLL 2
+#define EVENT_DMA 3
+#define NUM_EVENTS 4
+
+#define NO_EVENT UINT64_MAX
+
+/**
+ * @brief
+ * Master clock and the deadline of every pending event. Components work out
+ * when they next need to do something and schedule it here, in between they
+ * are left alone and the cpu just runs. Each component has at most one event
+ * pending, so the table is indexed by event and the earliest deadline cached.
+ */
+class Scheduler{
+    public:
+        // cycles since power on. While an instruction executes this is still the cycle it started on
+        uint64_t now = 0;
+        // earliest deadline in the table, NO_EVENT if nothing is pending
+        uint64_t nextDeadline = NO_EVENT;
+
+        Scheduler();
+        void schedule(int event, uint64_t deadline);
+        void cancel(int event);
+        int popDue();
+
+    private:
+        uint64_t deadlines[NUM_EVENTS];
+
+        void findNextDeadline();
+};
@@ -2,41 +2,103 @@
 
 #include "timer.hh"
 
-Timer::Timer(Memory *memory, Interrupt *interrupt){
+Timer::Timer(Memory *memory, Interrupt *interrupt, Scheduler *scheduler){
     this->memory = memory;
     this->interrupt = interrupt;
+    this->scheduler = scheduler;
+    this->lastSync = scheduler->now;
+
+    // DIV and TIMA have to be caught up before anything looks at them
+    std::function<uint8_t(uint16_t)> syncRead = [this](uint16_t address){
+        sync();
+        return this->memory->memory[address];
+    };
+
+    // count up to the writing instruction with the old settings, then find the next overflow with the new ones
+    std::function<void(uint16_t, uint8_t)> syncWrite = [this](uint16_t address, uint8_t content){
+        sync();
+        this->memory->memory[address] = content;
+        reschedule();
+    };
+
+    memory->registerIO(DIV, syncRead, [this](uint16_t, uint8_t){
+        // writing to the divider register resets it
+        sync();
+        this->memory->memory[DIV] = 0;
+    });
+    memory->registerIO(TIMA, syncRead, syncWrite);
+    memory->registerIO(TMA, nullptr, syncWrite);
+    memory->registerIO(TAC, nullptr, syncWrite);
+}
+
+/**
+ * @brief
+ * Count the cycles since the last sync, up to the start of the instruction
+ * running now. That is the same DIV and TIMA as stepping the timer after
+ * every instruction, since TAC can only change through writeByte, which syncs
+ * first.
+ */
+void Timer::sync(){
+    int cycles = scheduler->now - lastSync;
+    lastSync = scheduler->now;
+    if(cycles == 0){
+        return;
+    }
+
+    incrementDIV(cycles);
+    if(clockEnabled()){
+        incrementTIMA(cycles);
+    }
+}
+
+// schedule the next TIMA overflow, called after anything that moves it
+void Timer::reschedule(){
+    int cycles = cyclesToOverflow();
+    if(cycles < 0){
+        scheduler->cancel(EVENT_TIMER);
+        return;
+    }
+
+    scheduler->schedule(EVENT_TIMER, lastSync + cycles);
 }
 
 void Timer::incrementDIV(int cycles){
     divCount += cycles;
 
-    // overflow
-    if(divCount >= 0xFF){
-        divCount -= 0xFF;
-        memory->memory[DIV]++;
-    }
+    // overflow, a sync can cover any number of increments
+    memory->memory[DIV] += divCount / 0xFF;
+    divCount %= 0xFF;
 }
 
 void Timer::incrementTIMA(int cycles){
     // handle overflow
     clockCycles += cycles;
 
-    // update according to TAC rate 
-    if(clockCycles >= timeControl()){
-        clockCycles -= timeControl();
-        if(memory->readByte(TIMA) == 0xFF){
-            memory->writeByte(TIMA, memory->readByte(TMA));
+    // update according to TAC rate, a single sync can cover more than one tick
+    int rate = timeControl();
+    while(clockCycles >= rate){
+        clockCycles -= rate;
+        if(memory->memory[TIMA] == 0xFF){
+            memory->memory[TIMA] = memory->memory[TMA];
             interrupt->requestInterrupt(TIMER);
-            return;
         }
         else{
-            memory->writeByte(TIMA, memory->readByte(TIMA) + 1);
+            memory->memory[TIMA]++;
         }
     }
 }
 
+// cycles until TIMA overflows and requests the timer interrupt, -1 if the timer is stopped
+int Timer::cyclesToOverflow(){
+    if(!clockEnabled()){
+        return -1;
+    }
+
+    return (0x100 - memory->memory[TIMA]) * timeControl() - clockCycles;
+}
+
 int Timer::timeControl(){
-    uint8_t clockSelect =  memory->readByte(TAC) & 0x03;
+    uint8_t clockSelect =  memory->memory[TAC] & 0x03;
     switch (clockSelect){
         case 0x00:
             return 1024;
@@ -57,5 +119,5 @@ int Timer::timeControl(){
 }
 
 bool Timer::clockEnabled(){
-    return memory->readByte(TAC) & (1 << 2) ? true : false;
+    return memory->memory[TAC] & (1 << 2) ? true : false;
 }
\ No newline at end of file
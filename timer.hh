@@ -4,24 +4,38 @@
 
 #include "memory.hh"
 #include "interrupt.hh"
+#include "scheduler.hh"
 
 #define DIV 0xFF04
 #define TIMA 0xFF05
 #define TMA 0xFF06
 #define TAC 0xFF07
 
+/**
+ * @brief
+ * DIV and TIMA are only brought up to date when something looks at them
+ * (a read, a write to a timer register, the end of an update). The only
+ * thing the timer does on its own is overflow TIMA, which is scheduled.
+ */
 class Timer {
     public:
         int divCount = 0;
         int clockCycles = 0;
 
-        Timer(Memory *memory, Interrupt *interrupt);
+        Timer(Memory *memory, Interrupt *interrupt, Scheduler *scheduler);
+        void sync();
+        void reschedule();
         void incrementDIV(int cycles);
         void incrementTIMA(int cycles);
         int timeControl();
+        int cyclesToOverflow();
 
         bool clockEnabled();
     private:
         Memory *memory;
         Interrupt *interrupt;
-};
\ No newline at end of file
+        Scheduler *scheduler;
+
+        // cycle the registers were last brought up to date
+        uint64_t lastSync = 0;
+};
@@ -0,0 +1,31 @@
+#include <fstream>
+
+#include "trace.hh"
+
+void Tracer::enable(bool val){
+    // only pay for the buffer once tracing is actually used
+    if(val && buffer.empty()){
+        buffer.resize(TRACE_BUFFER_SIZE);
+    }
+    enabled = val;
+}
+
+bool Tracer::dump(std::string filename){
+    std::ofstream traceFile(filename, std::ios::binary);
+    if(traceFile.fail()){
+        std::cout << "could not open trace file " << filename << std::endl;
+        return false;
+    }
+
+    uint64_t buffered = recordCount < TRACE_BUFFER_SIZE ? recordCount : TRACE_BUFFER_SIZE;
+    TraceFileHeader header = {TRACE_MAGIC, TRACE_VERSION, buffered};
+    traceFile.write((char *) &header, sizeof(header));
+
+    // once the ring buffer has wrapped the oldest record sits right after the newest
+    uint64_t first = recordCount - buffered;
+    for(uint64_t i = first; i < recordCount; i++){
+        traceFile.write((char *) &buffer[i & (TRACE_BUFFER_SIZE - 1)], sizeof(TraceRecord));
+    }
+
+    return traceFile.good();
+}
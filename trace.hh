@@ -0,0 +1,60 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// number of records kept by the ring buffer, must be a power of two
+#define TRACE_BUFFER_SIZE 0x10000
+
+#define TRACE_MAGIC 0x52544D47
+#define TRACE_VERSION 1
+
+/**
+ * @brief
+ * Fixed size snapshot of the cpu taken right before an instruction executes.
+ * Tracing is compiled in with ENABLE_TRACE (make TRACE=1) and stays off until
+ * enabled at runtime, so a normal build pays nothing for it.
+ */
+struct TraceRecord{
+    uint16_t programCounter;
+    uint16_t stackPointer;
+    uint16_t af;
+    uint16_t bc;
+    uint16_t de;
+    uint16_t hl;
+    // the opcode followed by the next three bytes in memory
+    uint8_t pcmem[4];
+    uint8_t lcdControl;
+    uint8_t ime;
+    // cycles the instruction took to execute
+    uint8_t cycles;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(TraceRecord) == 20, "trace records are written to disk as is");
+
+struct TraceFileHeader{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t recordCount;
+};
+
+class Tracer{
+    public:
+        bool enabled = false;
+        // total records written, the buffer only holds the last TRACE_BUFFER_SIZE of them
+        uint64_t recordCount = 0;
+
+        void enable(bool val);
+
+        TraceRecord *nextRecord(){
+            return &buffer[recordCount++ & (TRACE_BUFFER_SIZE - 1)];
+        }
+
+        // writes the buffered records to a file, oldest first
+        bool dump(std::string filename);
+
+    private:
+        std::vector<TraceRecord> buffer;
+};
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include "trace.hh"
+#include "opcodes.hh"
+
+/**
+ * @brief
+ * Offline decoder for instruction traces written by the tracer. Prints the
+ * register dump the cpu used to print while in debug mode, or the Gameboy
+ * Doctor log format with --doctor.
+ *
+ * usage: ./gameboy-tracedecode traceFile [--doctor]
+ */
+
+#define FLAG_Z 7
+#define FLAG_N 6
+#define FLAG_H 5
+#define FLAG_C 4
+
+static int flag(const TraceRecord &record, int flag){
+    return (record.af >> flag) & 1;
+}
+
+static void printText(const TraceRecord &record){
+    printf("\t\n----------------------\n");
+    printf("PC: 0x%x AF: 0x%x BC: 0x%x DE: 0x%x HL: 0x%x SP: 0x%x IME 0x%x\n", record.programCounter, record.af, record.bc, record.de, record.hl, record.stackPointer, record.ime);
+    printf("Flags: Z: %d N: %d H: %d C: %d\n", flag(record, FLAG_Z), flag(record, FLAG_N), flag(record, FLAG_H), flag(record, FLAG_C));
+    printf("lcd control status: 0x%x\n", record.lcdControl);
+    if(record.pcmem[0] == 0xCB){
+        printf("\t%s\n", prefixOpcodeTable[record.pcmem[1]].mnemonic);
+    }
+    else{
+        printf("\t%s\n", opcodeTable[record.pcmem[0]].mnemonic);
+    }
+}
+
+static void printDoctor(const TraceRecord &record){
+    printf("A:%02X F:%02X B:%02X C:%02X D:%02X E:%02X H:%02X L:%02X SP:%04X PC:%04X PCMEM:%02X,%02X,%02X,%02X\n",
+        record.af >> 8, record.af & 0xFF, record.bc >> 8, record.bc & 0xFF, record.de >> 8, record.de & 0xFF, record.hl >> 8, record.hl & 0xFF,
+        record.stackPointer, record.programCounter, record.pcmem[0], record.pcmem[1], record.pcmem[2], record.pcmem[3]);
+}
+
+int main(int argc, char **argv){
+    if(argc < 2 || (argc == 3 && std::string(argv[2]) != "--doctor") || argc > 3){
+        std::cout << "usage: ./gameboy-tracedecode traceFile [--doctor]" << std::endl;
+        return 1;
+    }
+
+    bool doctor = argc == 3;
+
+    std::ifstream traceFile(argv[1], std::ios::binary);
+    if(traceFile.fail()){
+        std::cout << "could not open file... :(" << std::endl;
+        return 1;
+    }
+
+    TraceFileHeader header;
+    traceFile.read((char *) &header, sizeof(header));
+    if(!traceFile || header.magic != TRACE_MAGIC || header.version != TRACE_VERSION){
+        std::cout << "not a trace file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    TraceRecord record;
+    for(uint64_t i = 0; i < header.recordCount && traceFile.read((char *) &record, sizeof(record)); i++){
+        if(doctor){
+            printDoctor(record);
+        }
+        else{
+            printText(record);
+        }
+    }
+
+    return 0;
+}